@@ -4,6 +4,18 @@
 #include <cmath>
 #include <ctime>
 #include <cstdlib>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <queue>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include "../common/instrument.h"
 using namespace std;
 
 class Complex {
@@ -63,14 +75,21 @@ void merge(vector<Complex>& v, int left, int mid, int right) {
     }
 }
 
-void mergeSort(vector<Complex>& v, int left, int right) {
+void mergeSortRange(vector<Complex>& v, int left, int right) {
     if (left >= right) return;
     int mid = (left + right) / 2;
-    mergeSort(v, left, mid);
-    mergeSort(v, mid + 1, right);
+    mergeSortRange(v, left, mid);
+    mergeSortRange(v, mid + 1, right);
     merge(v, left, mid, right);
 }
 
+// ׮ֻڣݹ鲿ֲʱ
+void mergeSort(vector<Complex>& v, int left, int right) {
+    INSTR_SCOPE("mergeSort");
+    INSTR_HIST("mergeSort.n", right - left + 1);
+    mergeSortRange(v, left, right);
+}
+
 int findComplex(const vector<Complex>& v, const Complex& target) {
     for (int i = 0; i < v.size(); i++) {
         if (v[i] == target) return i;
@@ -106,7 +125,662 @@ vector<Complex> rangeSearch(const vector<Complex>& v, double m1, double m2) {
     return result;
 }
 
-int main() {
+// ===================== FFT =====================
+
+// ṹ飨SoAʽĸУʵ鲿ֿţ
+struct ComplexArray {
+    vector<double> re, im;
+
+    explicit ComplexArray(size_t n = 0) : re(n), im(n) {}
+    size_t size() const { return re.size(); }
+
+    static ComplexArray fromVector(const vector<Complex>& v) {
+        ComplexArray a(v.size());
+        for (size_t i = 0; i < v.size(); i++) { a.re[i] = v[i].real; a.im[i] = v[i].imag; }
+        return a;
+    }
+
+    vector<Complex> toVector() const {
+        vector<Complex> v(size());
+        for (size_t i = 0; i < size(); i++) v[i] = Complex(re[i], im[i]);
+        return v;
+    }
+};
+
+const double FFT_PI = acos(-1.0);
+
+//  n  FFT ƻn ֽΪ 42 Ͳ MAX_RADIX Сûϻ Stockham Զ㷨𼶼㣨Ƶʳȡ
+// ÿ p ٳתӣȻ˳򣩣ʱ Bluestein 㷨Ϊ 2 ݳȵѭ
+// תڹʱãƻȻ棬 FFTPlan::get ȡ
+class FFTPlan {
+public:
+    static const int MAX_RADIX = 31;
+
+    explicit FFTPlan(int n) : n(n) {
+        int rest = n;
+        vector<int> radices;
+        while (rest % 4 == 0) { radices.push_back(4); rest /= 4; }
+        while (rest % 2 == 0) { radices.push_back(2); rest /= 2; }
+        for (int p = 3; p * p <= rest; p += 2)
+            while (rest % p == 0) { radices.push_back(p); rest /= p; }
+        if (rest > 1) radices.push_back(rest);
+
+        if (!radices.empty() && *max_element(radices.begin(), radices.end()) > MAX_RADIX) {
+            buildBluestein();
+            return;
+        }
+
+        int len = n, stride = 1;
+        for (int p : radices) {
+            Stage st;
+            st.p = p;
+            st.m = len / p;
+            st.s = stride;
+            //  q  t · w^(q*t)w = exp(-2i / len) [q][t] 
+            st.wr.resize((size_t)st.m * p);
+            st.wi.resize((size_t)st.m * p);
+            for (int q = 0; q < st.m; q++)
+                for (int t = 0; t < p; t++) {
+                    double a = -2 * FFT_PI * (double)((long long)q * t % len) / len;
+                    st.wr[(size_t)q * p + t] = cos(a);
+                    st.wi[(size_t)q * p + t] = sin(a);
+                }
+            // p  DFT ϵ exp(-2i jt / p)
+            st.cr.resize(p);
+            st.ci.resize(p);
+            for (int j = 0; j < p; j++) { st.cr[j] = cos(-2 * FFT_PI * j / p); st.ci[j] = sin(-2 * FFT_PI * j / p); }
+            stages.push_back(st);
+            len /= p;
+            stride *= p;
+        }
+    }
+
+    int size() const { return n; }
+    bool usesBluestein() const { return bluestein != nullptr; }
+
+    // ԭ任 X_k =  x_j exp(-2i jk/n)
+    void forward(double* re, double* im, int threads = 1) const {
+        if (n <= 1) return;
+        if (bluestein) { runBluestein(re, im, threads); return; }
+        unique_ptr<double[]> tr(new double[n]), ti(new double[n]);
+        double *xr = re, *xi = im, *yr = tr.get(), *yi = ti.get();
+        for (const Stage& st : stages) {
+            runStage(st, xr, xi, yr, yi, threads);
+            swap(xr, yr);
+            swap(xi, yi);
+        }
+        if (xr != re) {
+            copy(xr, xr + n, re);
+            copy(xi, xi + n, im);
+        }
+    }
+
+    // ԭ任 1/n ţʵ鲿任൱ڶԹ FFT
+    void inverse(double* re, double* im, int threads = 1) const {
+        forward(im, re, threads);
+        double scale = 1.0 / n;
+        for (int i = 0; i < n; i++) { re[i] *= scale; im[i] *= scale; }
+    }
+
+    static shared_ptr<const FFTPlan> get(int n) {
+        static mutex mtx;
+        static map<int, shared_ptr<const FFTPlan>> cache;
+        {
+            lock_guard<mutex> lk(mtx);
+            auto it = cache.find(n);
+            if (it != cache.end()) return it->second;
+        }
+        // ⹹죬Bluestein ƻݹȡ 2 ݳȵļƻ
+        shared_ptr<const FFTPlan> plan = make_shared<FFTPlan>(n);
+        lock_guard<mutex> lk(mtx);
+        return cache.insert({ n, plan }).first->second;
+    }
+
+private:
+    struct Stage {
+        int p, m, s;           // ȣǰг p * m s 
+        vector<double> wr, wi; // ת [q][t]
+        vector<double> cr, ci; // p  DFT ϵ
+    };
+
+    int n;
+    vector<Stage> stages;
+
+    // BluesteinX_k = c_k _j (x_j c_j) conj(c_{k-j})c_k = exp(-i k^2/n)ó M  FFT 
+    struct Bluestein {
+        int M;
+        shared_ptr<const FFTPlan> sub;
+        vector<double> cr, ci;   // c_k
+        vector<double> br, bi;   // conj(c) ѭŲ FFT
+    };
+    shared_ptr<Bluestein> bluestein;
+
+    void buildBluestein() {
+        auto b = make_shared<Bluestein>();
+        b->M = 1;
+        while (b->M < 2 * n - 1) b->M *= 2;
+        b->sub = get(b->M);
+        b->cr.resize(n);
+        b->ci.resize(n);
+        for (int k = 0; k < n; k++) {
+            // k^2  2n ȡģٻǶȣ k ʱʧ
+            double a = -FFT_PI * (double)((long long)k * k % (2LL * n)) / n;
+            b->cr[k] = cos(a);
+            b->ci[k] = sin(a);
+        }
+        b->br.assign(b->M, 0);
+        b->bi.assign(b->M, 0);
+        for (int k = 0; k < n; k++) {
+            b->br[k] = b->cr[k];
+            b->bi[k] = -b->ci[k];
+            if (k > 0) { b->br[b->M - k] = b->cr[k]; b->bi[b->M - k] = -b->ci[k]; }
+        }
+        b->sub->forward(b->br.data(), b->bi.data());
+        bluestein = b;
+    }
+
+    void runBluestein(double* re, double* im, int threads) const {
+        const Bluestein& b = *bluestein;
+        vector<double> ar(b.M, 0), ai(b.M, 0);
+        for (int k = 0; k < n; k++) {
+            ar[k] = re[k] * b.cr[k] - im[k] * b.ci[k];
+            ai[k] = re[k] * b.ci[k] + im[k] * b.cr[k];
+        }
+        b.sub->forward(ar.data(), ai.data(), threads);
+        for (int k = 0; k < b.M; k++) {
+            double r = ar[k] * b.br[k] - ai[k] * b.bi[k];
+            ai[k] = ar[k] * b.bi[k] + ai[k] * b.br[k];
+            ar[k] = r;
+        }
+        b.sub->forward(ai.data(), ar.data(), threads);   // δŵ任
+        double scale = 1.0 / b.M;
+        for (int k = 0; k < n; k++) {
+            double r = ar[k] * scale, i = ai[k] * scale;
+            re[k] = r * b.cr[k] - i * b.ci[k];
+            im[k] = r * b.ci[k] + i * b.cr[k];
+        }
+    }
+
+    // һ Stockham q  [0, m)k  [0, s)ȡ a_j = x[k + s(q + mj)]
+    //  y[k + s(pq + t)] = w^(qt) _j a_j exp(-2i jt/p)ģʱ qʱ kָ߳
+    void runStage(const Stage& st, const double* xr, const double* xi, double* yr, double* yi, int threads) const {
+        if (threads <= 1 || n < (1 << 15)) { stageRange(st, xr, xi, yr, yi, 0, st.m, 0, st.s); return; }
+        vector<thread> pool;
+        if (st.m >= threads) {
+            int chunk = (st.m + threads - 1) / threads;
+            for (int t = 0; t < threads; t++) {
+                int q0 = min(st.m, t * chunk), q1 = min(st.m, q0 + chunk);
+                pool.push_back(thread([=, &st] { stageRange(st, xr, xi, yr, yi, q0, q1, 0, st.s); }));
+            }
+        }
+        else {
+            int chunk = ((st.s + threads - 1) / threads + 3) / 4 * 4;
+            for (int t = 0; t < threads; t++) {
+                int k0 = min(st.s, t * chunk), k1 = min(st.s, k0 + chunk);
+                pool.push_back(thread([=, &st] { stageRange(st, xr, xi, yr, yi, 0, st.m, k0, k1); }));
+            }
+        }
+        for (auto& th : pool) th.join();
+    }
+
+    void stageRange(const Stage& st, const double* xr, const double* xi, double* yr, double* yi,
+        int q0, int q1, int k0, int k1) const {
+        const int p = st.p, m = st.m, s = st.s;
+        for (int q = q0; q < q1; q++) {
+            const double* wr = &st.wr[(size_t)q * p];
+            const double* wi = &st.wi[(size_t)q * p];
+            size_t in = (size_t)s * q, out = (size_t)s * p * q, step = (size_t)s * m;
+            int k = k0;
+#if defined(__AVX2__)
+            if (p == 2 || p == 4)
+                for (; k + 4 <= k1; k += 4) butterflyAVX(p, xr + in + k, xi + in + k, step, yr + out + k, yi + out + k, s, wr, wi);
+#endif
+            for (; k < k1; k++) {
+                const double *ar = xr + in + k, *ai = xi + in + k;
+                double *br = yr + out + k, *bi = yi + out + k;
+                if (p == 2) {
+                    double r0 = ar[0], i0 = ai[0], r1 = ar[step], i1 = ai[step];
+                    br[0] = r0 + r1; bi[0] = i0 + i1;
+                    double dr = r0 - r1, di = i0 - i1;
+                    br[s] = dr * wr[1] - di * wi[1];
+                    bi[s] = dr * wi[1] + di * wr[1];
+                }
+                else if (p == 4) {
+                    double r0 = ar[0], i0 = ai[0], r1 = ar[step], i1 = ai[step];
+                    double r2 = ar[2 * step], i2 = ai[2 * step], r3 = ar[3 * step], i3 = ai[3 * step];
+                    double b0r = r0 + r2, b0i = i0 + i2, b1r = r0 - r2, b1i = i0 - i2;
+                    double b2r = r1 + r3, b2i = i1 + i3, b3r = i1 - i3, b3i = r3 - r1;   // (a1 - a3) * (-i)
+                    br[0] = b0r + b2r; bi[0] = b0i + b2i;
+                    double tr = b1r + b3r, ti = b1i + b3i;
+                    br[s] = tr * wr[1] - ti * wi[1]; bi[s] = tr * wi[1] + ti * wr[1];
+                    tr = b0r - b2r; ti = b0i - b2i;
+                    br[2 * s] = tr * wr[2] - ti * wi[2]; bi[2 * s] = tr * wi[2] + ti * wr[2];
+                    tr = b1r - b3r; ti = b1i - b3i;
+                    br[3 * s] = tr * wr[3] - ti * wi[3]; bi[3 * s] = tr * wi[3] + ti * wr[3];
+                }
+                else {
+                    double vr[MAX_RADIX], vi[MAX_RADIX];
+                    for (int j = 0; j < p; j++) { vr[j] = ar[j * step]; vi[j] = ai[j * step]; }
+                    for (int t = 0; t < p; t++) {
+                        double sr = 0, si = 0;
+                        for (int j = 0, idx = 0; j < p; j++, idx = (idx + t) % p) {
+                            sr += vr[j] * st.cr[idx] - vi[j] * st.ci[idx];
+                            si += vr[j] * st.ci[idx] + vi[j] * st.cr[idx];
+                        }
+                        br[(size_t)t * s] = sr * wr[t] - si * wi[t];
+                        bi[(size_t)t * s] = sr * wi[t] + si * wr[t];
+                    }
+                }
+            }
+        }
+    }
+
+#if defined(__AVX2__)
+    // һδ 4  k Ļ 2 /  4 ΣתӶ 4  k ͬ
+    static void butterflyAVX(int p, const double* ar, const double* ai, size_t step, double* br, double* bi, int s,
+        const double* wr, const double* wi) {
+        auto cmul = [](__m256d xr, __m256d xi, double r, double i, __m256d& outR, __m256d& outI) {
+            __m256d vr = _mm256_set1_pd(r), vi = _mm256_set1_pd(i);
+            outR = _mm256_sub_pd(_mm256_mul_pd(xr, vr), _mm256_mul_pd(xi, vi));
+            outI = _mm256_add_pd(_mm256_mul_pd(xr, vi), _mm256_mul_pd(xi, vr));
+        };
+        __m256d r0 = _mm256_loadu_pd(ar), i0 = _mm256_loadu_pd(ai);
+        __m256d r1 = _mm256_loadu_pd(ar + step), i1 = _mm256_loadu_pd(ai + step);
+        __m256d oR, oI;
+        if (p == 2) {
+            _mm256_storeu_pd(br, _mm256_add_pd(r0, r1));
+            _mm256_storeu_pd(bi, _mm256_add_pd(i0, i1));
+            cmul(_mm256_sub_pd(r0, r1), _mm256_sub_pd(i0, i1), wr[1], wi[1], oR, oI);
+            _mm256_storeu_pd(br + s, oR);
+            _mm256_storeu_pd(bi + s, oI);
+            return;
+        }
+        __m256d r2 = _mm256_loadu_pd(ar + 2 * step), i2 = _mm256_loadu_pd(ai + 2 * step);
+        __m256d r3 = _mm256_loadu_pd(ar + 3 * step), i3 = _mm256_loadu_pd(ai + 3 * step);
+        __m256d b0r = _mm256_add_pd(r0, r2), b0i = _mm256_add_pd(i0, i2);
+        __m256d b1r = _mm256_sub_pd(r0, r2), b1i = _mm256_sub_pd(i0, i2);
+        __m256d b2r = _mm256_add_pd(r1, r3), b2i = _mm256_add_pd(i1, i3);
+        __m256d b3r = _mm256_sub_pd(i1, i3), b3i = _mm256_sub_pd(r3, r1);
+        _mm256_storeu_pd(br, _mm256_add_pd(b0r, b2r));
+        _mm256_storeu_pd(bi, _mm256_add_pd(b0i, b2i));
+        cmul(_mm256_add_pd(b1r, b3r), _mm256_add_pd(b1i, b3i), wr[1], wi[1], oR, oI);
+        _mm256_storeu_pd(br + s, oR);
+        _mm256_storeu_pd(bi + s, oI);
+        cmul(_mm256_sub_pd(b0r, b2r), _mm256_sub_pd(b0i, b2i), wr[2], wi[2], oR, oI);
+        _mm256_storeu_pd(br + 2 * s, oR);
+        _mm256_storeu_pd(bi + 2 * s, oI);
+        cmul(_mm256_sub_pd(b1r, b3r), _mm256_sub_pd(b1i, b3i), wr[3], wi[3], oR, oI);
+        _mm256_storeu_pd(br + 3 * s, oR);
+        _mm256_storeu_pd(bi + 3 * s, oI);
+    }
+#endif
+};
+
+void fft(ComplexArray& a, int threads = 1) {
+    FFTPlan::get((int)a.size())->forward(a.re.data(), a.im.data(), threads);
+}
+
+void ifft(ComplexArray& a, int threads = 1) {
+    FFTPlan::get((int)a.size())->inverse(a.re.data(), a.im.data(), threads);
+}
+
+void fft(vector<Complex>& v, int threads = 1) {
+    ComplexArray a = ComplexArray::fromVector(v);
+    fft(a, threads);
+    v = a.toVector();
+}
+
+void ifft(vector<Complex>& v, int threads = 1) {
+    ComplexArray a = ComplexArray::fromVector(v);
+    ifft(a, threads);
+    v = a.toVector();
+}
+
+//  O(n^2) DFTΪ׼;ȲգǶȰ jk mod n ȡۼ long double
+vector<Complex> naiveDFT(const vector<Complex>& v, bool inverse = false) {
+    int n = v.size();
+    vector<long double> c(n), sn(n);
+    for (int k = 0; k < n; k++) {
+        long double a = (inverse ? 2 : -2) * (long double)FFT_PI * k / n;
+        c[k] = cos(a);
+        sn[k] = sin(a);
+    }
+    vector<Complex> out(n);
+    for (int k = 0; k < n; k++) {
+        long double sr = 0, si = 0;
+        for (int j = 0, idx = 0; j < n; j++, idx = (idx + k) % n) {
+            sr += v[j].real * c[idx] - v[j].imag * sn[idx];
+            si += v[j].real * sn[idx] + v[j].imag * c[idx];
+        }
+        if (inverse) { sr /= n; si /= n; }
+        out[k] = Complex((double)sr, (double)si);
+    }
+    return out;
+}
+
+// ===================== ƽ k-d  =====================
+
+// ʽ k-d 㰴 [lo, hi) ĸ mid = (lo + hi) / 2ֱ [lo, mid)  [mid + 1, hi)
+// ָ롣ÿڿȽϴз֣ nth_element ȡλ O(n log n)
+//  LEAF_SIZE ֱɨ衣ͬʱȡԭ±Сĵ㣬ɨһ
+class ComplexKDTree {
+public:
+    static const int LEAF_SIZE = 8;
+
+    explicit ComplexKDTree(const vector<Complex>& points) {
+        int n = points.size();
+        vector<int> order(n);
+        for (int i = 0; i < n; i++) order[i] = i;
+        split.assign(n, 0);
+        build(points, order, 0, n);
+        xs.resize(n); ys.resize(n); ids = order;
+        for (int i = 0; i < n; i++) { xs[i] = points[order[i]].real; ys[i] = points[order[i]].imag; }
+    }
+
+    int size() const { return ids.size(); }
+
+    // ԭ±꣬ -1
+    int nearest(const Complex& q) const {
+        Best best = { 1e300, -1 };
+        nearest(q.real, q.imag, 0, size(), best);
+        return best.id;
+    }
+
+    //  k ԭ±꣬
+    void kNearest(const Complex& q, int k, vector<int>& out) const {
+        out.clear();
+        if (k <= 0) return;
+        priority_queue<pair<double, int>> heap;   // ѣѶǵǰ k 
+        kNearest(q.real, q.imag, k, 0, size(), heap);
+        out.resize(heap.size());
+        for (int i = (int)heap.size() - 1; i >= 0; i--) { out[i] = heap.top().second; heap.pop(); }
+    }
+
+    // ʵ [x1, x2]鲿 [y1, y2] ڵеԭ±
+    void window(double x1, double y1, double x2, double y2, vector<int>& out) const {
+        out.clear();
+        window(x1, y1, x2, y2, 0, size(), out);
+    }
+
+    // ѯѯƽָ threads ߳
+    void nearestBatch(const vector<Complex>& queries, vector<int>& out, int threads = 1) const {
+        out.resize(queries.size());
+        runBatch((int)queries.size(), threads, [&](int i) { out[i] = nearest(queries[i]); });
+    }
+
+    void kNearestBatch(const vector<Complex>& queries, int k, vector<vector<int>>& out, int threads = 1) const {
+        out.resize(queries.size());
+        runBatch((int)queries.size(), threads, [&](int i) { kNearest(queries[i], k, out[i]); });
+    }
+
+private:
+    vector<double> xs, ys;
+    vector<int> ids;
+    vector<unsigned char> split;   //  mid з꣺0 ʵ1 鲿
+
+    struct Best {
+        double d2;
+        int id;
+    };
+
+    static double coord(const Complex& c, int dim) { return dim ? c.imag : c.real; }
+    double coordAt(int i, int dim) const { return dim ? ys[i] : xs[i]; }
+
+    void build(const vector<Complex>& pts, vector<int>& order, int lo, int hi) {
+        if (hi - lo <= LEAF_SIZE) return;
+        double minX = 1e300, maxX = -1e300, minY = 1e300, maxY = -1e300;
+        for (int i = lo; i < hi; i++) {
+            const Complex& c = pts[order[i]];
+            minX = min(minX, c.real); maxX = max(maxX, c.real);
+            minY = min(minY, c.imag); maxY = max(maxY, c.imag);
+        }
+        int dim = (maxY - minY > maxX - minX) ? 1 : 0;
+        int mid = (lo + hi) / 2;
+        nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi, [&](int a, int b) {
+            return coord(pts[a], dim) < coord(pts[b], dim);
+        });
+        split[mid] = dim;
+        build(pts, order, lo, mid);
+        build(pts, order, mid + 1, hi);
+    }
+
+    void consider(double qx, double qy, int i, Best& best) const {
+        double dx = xs[i] - qx, dy = ys[i] - qy, d2 = dx * dx + dy * dy;
+        if (d2 < best.d2 || (d2 == best.d2 && ids[i] < best.id)) best = { d2, ids[i] };
+    }
+
+    void nearest(double qx, double qy, int lo, int hi, Best& best) const {
+        if (hi - lo <= LEAF_SIZE) {
+            for (int i = lo; i < hi; i++) consider(qx, qy, i, best);
+            return;
+        }
+        int mid = (lo + hi) / 2, dim = split[mid];
+        double diff = (dim ? qy : qx) - coordAt(mid, dim);
+        consider(qx, qy, mid, best);
+        // Ƚѯһ࣬һֻз߱ȵǰŸһʱŽ
+        if (diff < 0) {
+            nearest(qx, qy, lo, mid, best);
+            if (diff * diff <= best.d2) nearest(qx, qy, mid + 1, hi, best);
+        }
+        else {
+            nearest(qx, qy, mid + 1, hi, best);
+            if (diff * diff <= best.d2) nearest(qx, qy, lo, mid, best);
+        }
+    }
+
+    void offer(double qx, double qy, int i, int k, priority_queue<pair<double, int>>& heap) const {
+        double dx = xs[i] - qx, dy = ys[i] - qy;
+        pair<double, int> cand(dx * dx + dy * dy, ids[i]);
+        if ((int)heap.size() < k) heap.push(cand);
+        else if (cand < heap.top()) { heap.pop(); heap.push(cand); }
+    }
+
+    void kNearest(double qx, double qy, int k, int lo, int hi, priority_queue<pair<double, int>>& heap) const {
+        if (hi - lo <= LEAF_SIZE) {
+            for (int i = lo; i < hi; i++) offer(qx, qy, i, k, heap);
+            return;
+        }
+        int mid = (lo + hi) / 2, dim = split[mid];
+        double diff = (dim ? qy : qx) - coordAt(mid, dim);
+        offer(qx, qy, mid, k, heap);
+        int nearLo = diff < 0 ? lo : mid + 1, nearHi = diff < 0 ? mid : hi;
+        int farLo = diff < 0 ? mid + 1 : lo, farHi = diff < 0 ? hi : mid;
+        kNearest(qx, qy, k, nearLo, nearHi, heap);
+        if ((int)heap.size() < k || diff * diff <= heap.top().first) kNearest(qx, qy, k, farLo, farHi, heap);
+    }
+
+    void window(double x1, double y1, double x2, double y2, int lo, int hi, vector<int>& out) const {
+        if (hi - lo <= LEAF_SIZE) {
+            for (int i = lo; i < hi; i++)
+                if (xs[i] >= x1 && xs[i] <= x2 && ys[i] >= y1 && ys[i] <= y2) out.push_back(ids[i]);
+            return;
+        }
+        int mid = (lo + hi) / 2, dim = split[mid];
+        double v = coordAt(mid, dim), a = dim ? y1 : x1, b = dim ? y2 : x2;
+        if (xs[mid] >= x1 && xs[mid] <= x2 && ys[mid] >= y1 && ys[mid] <= y2) out.push_back(ids[mid]);
+        // 궼 <= v >= v
+        if (a <= v) window(x1, y1, x2, y2, lo, mid, out);
+        if (b >= v) window(x1, y1, x2, y2, mid + 1, hi, out);
+    }
+
+    template <class F>
+    static void runBatch(int n, int threads, F f) {
+        if (threads <= 1 || n < 1024) {
+            for (int i = 0; i < n; i++) f(i);
+            return;
+        }
+        vector<thread> pool;
+        int chunk = (n + threads - 1) / threads;
+        for (int t = 0; t < threads; t++) {
+            int b = min(n, t * chunk), e = min(n, b + chunk);
+            pool.push_back(thread([=] { for (int i = b; i < e; i++) f(i); }));
+        }
+        for (auto& th : pool) th.join();
+    }
+};
+
+// ɨ㣬Ϊգͬȡ±С
+int nearestLinear(const vector<Complex>& v, const Complex& q) {
+    int best = -1;
+    double bestD2 = 1e300;
+    for (int i = 0; i < (int)v.size(); i++) {
+        double dx = v[i].real - q.real, dy = v[i].imag - q.imag, d2 = dx * dx + dy * dy;
+        if (d2 < bestD2) { bestD2 = d2; best = i; }
+    }
+    return best;
+}
+
+// ===================== ܲ =====================
+
+vector<Complex> randomSignal(int n, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> d(-1, 1);
+    vector<Complex> v(n);
+    for (auto& c : v) c = Complex(d(rng), d(rng));
+    return v;
+}
+
+double maxError(const vector<Complex>& a, const vector<Complex>& b) {
+    double err = 0, scale = 1e-300;
+    for (size_t i = 0; i < a.size(); i++) {
+        err = max(err, Complex(a[i].real - b[i].real, a[i].imag - b[i].imag).magnitude());
+        scale = max(scale, b[i].magnitude());
+    }
+    return err / scale;
+}
+
+// ֳȣ2 ݡϻ Bluestein O(n^2) DFT ȶԣ任ԭ
+void testFFTAccuracy() {
+    cout << "FFT Ȳԣ" << endl;
+    int sizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 12, 15, 16, 17, 30, 64, 97, 100, 128, 243, 256, 360, 509, 1000, 1024, 2310, 4096, 10007 };
+    bool allOk = true;
+    for (int n : sizes) {
+        vector<Complex> x = randomSignal(n, n);
+        vector<Complex> ref = naiveDFT(x);
+        vector<Complex> y = x;
+        fft(y);
+        double fwd = maxError(y, ref);
+        ifft(y);
+        double back = maxError(y, x);
+        bool ok = fwd < 1e-12 && back < 1e-12;
+        allOk = allOk && ok;
+        cout << "n=" << n << (FFTPlan::get(n)->usesBluestein() ? "Bluestein" : "")
+            << " 任: " << fwd << " : " << back << (ok ? "" : " ") << endl;
+    }
+    cout << "У: " << (allOk ? "ͨ" : "ʧ") << endl;
+}
+
+void benchFFT() {
+    auto ms = [](chrono::high_resolution_clock::time_point a, chrono::high_resolution_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cout << "\nFFT  O(n^2) DFT Ա" << endl;
+    for (int n : { 1024, 4096, 16384 }) {
+        vector<Complex> x = randomSignal(n, 1);
+        auto t0 = chrono::high_resolution_clock::now();
+        vector<Complex> ref = naiveDFT(x);
+        auto t1 = chrono::high_resolution_clock::now();
+        vector<Complex> y = x;
+        fft(y);
+        auto t2 = chrono::high_resolution_clock::now();
+        cout << "n=" << n << " | DFT(ms): " << ms(t0, t1) << " | FFT(ms): " << ms(t1, t2)
+            << " | ٱ: " << ms(t0, t1) / ms(t1, t2) << " | : " << maxError(y, ref) << endl;
+    }
+
+    int threads = max(1u, thread::hardware_concurrency());
+    cout << "\nģ FFTSoAԭأƻѻ棩" << endl;
+    for (int n : { 1 << 20, 1 << 22, 531441, 1000000, 1000003 }) {
+        ComplexArray a = ComplexArray::fromVector(randomSignal(n, 2));
+        FFTPlan::get(n);
+        auto t0 = chrono::high_resolution_clock::now();
+        fft(a, 1);
+        auto t1 = chrono::high_resolution_clock::now();
+        fft(a, threads);
+        auto t2 = chrono::high_resolution_clock::now();
+        cout << "n=" << n << (FFTPlan::get(n)->usesBluestein() ? "Bluestein" : "")
+            << " | ߳(ms): " << ms(t0, t1) << " | " << threads << " ߳(ms): " << ms(t1, t2) << endl;
+    }
+}
+
+// ӳ䳡򼶵㼯ϵ㡢k ں;δڲѯɨȶ
+void benchKDTree(int n, int queries) {
+    auto ms = [](chrono::high_resolution_clock::time_point a, chrono::high_resolution_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+    cout << "\nk-d " << endl;
+    vector<Complex> pts = randomSignal(n, 11);
+    // һЩظ㣬ͬʱȡ
+    for (int i = 0; i < n / 100; i++) pts[i * 37 % n] = pts[i];
+    vector<Complex> qs = randomSignal(queries, 12);
+
+    auto t0 = chrono::high_resolution_clock::now();
+    ComplexKDTree tree(pts);
+    auto t1 = chrono::high_resolution_clock::now();
+    vector<int> nn;
+    tree.nearestBatch(qs, nn, 1);
+    auto t2 = chrono::high_resolution_clock::now();
+    int threads = max(1u, thread::hardware_concurrency());
+    vector<int> nnPar;
+    tree.nearestBatch(qs, nnPar, threads);
+    auto t3 = chrono::high_resolution_clock::now();
+
+    int sample = 200;
+    auto t4 = chrono::high_resolution_clock::now();
+    bool ok = nn == nnPar;
+    for (int i = 0; i < sample && ok; i++) ok = nn[i] == nearestLinear(pts, qs[i]);
+    auto t5 = chrono::high_resolution_clock::now();
+
+    cout << n << "  | (ms): " << ms(t0, t1)
+        << " | " << queries << "  ߳(ms): " << ms(t1, t2)
+        << " | " << threads << " ߳(ms): " << ms(t2, t3)
+        << " | ɨÿ(ms): " << ms(t4, t5) / sample << endl;
+
+    vector<vector<int>> knn;
+    t0 = chrono::high_resolution_clock::now();
+    tree.kNearestBatch(qs, 8, knn, threads);
+    t1 = chrono::high_resolution_clock::now();
+    for (int i = 0; i < sample && ok; i++) {
+        vector<pair<double, int>> all(n);
+        for (int j = 0; j < n; j++) {
+            double dx = pts[j].real - qs[i].real, dy = pts[j].imag - qs[i].imag;
+            all[j] = { dx * dx + dy * dy, j };
+        }
+        partial_sort(all.begin(), all.begin() + 8, all.end());
+        for (int j = 0; j < 8 && ok; j++) ok = knn[i][j] == all[j].second;
+    }
+
+    vector<int> win;
+    long long found = 0;
+    t2 = chrono::high_resolution_clock::now();
+    for (int i = 0; i < 10000; i++) {
+        const Complex& c = qs[i % queries];
+        tree.window(c.real - 0.01, c.imag - 0.01, c.real + 0.01, c.imag + 0.01, win);
+        found += win.size();
+    }
+    t3 = chrono::high_resolution_clock::now();
+    for (int i = 0; i < 50 && ok; i++) {
+        const Complex& c = qs[i];
+        tree.window(c.real - 0.05, c.imag - 0.02, c.real + 0.05, c.imag + 0.02, win);
+        vector<int> ref;
+        for (int j = 0; j < n; j++)
+            if (pts[j].real >= c.real - 0.05 && pts[j].real <= c.real + 0.05 && pts[j].imag >= c.imag - 0.02 && pts[j].imag <= c.imag + 0.02)
+                ref.push_back(j);
+        sort(win.begin(), win.end());
+        ok = win == ref;
+    }
+    cout << queries << "  8 (ms): " << ms(t0, t1)
+        << " | 10000 δڲѯ(ms): " << ms(t2, t3) << " " << found << " 㣩"
+        << " | У: " << (ok ? "һ" : "һ") << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "bench") {
+        testFFTAccuracy();
+        benchFFT();
+        benchKDTree(1000000, 1000000);
+        return 0;
+    }
+
     srand(time(0));
     vector<Complex> v;
     for (int i = 0; i < 10; i++) {
@@ -170,5 +844,11 @@ int main() {
     for (auto& c : result) c.print(), cout << " ";
     cout << endl;
 
+    ComplexKDTree tree(v2);
+    Complex probe(4.6, 5.3);
+    cout << "\n(4.6,5.3)ĸ: ";
+    v2[tree.nearest(probe)].print();
+    cout << endl;
+
     return 0;
 }
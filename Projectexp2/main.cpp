@@ -6,6 +6,14 @@
 #include <sstream>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include "../common/instrument.h"
 using namespace std;
 
 bool isDigitChar(char c) {
@@ -33,30 +41,43 @@ double applyBinary(double a, double b, char op, bool& ok) {
     ok = false; return 0;
 }
 
-double applyFunction(const string& name, double x, bool& ok) {
+const char* const functionNames[] = { "sin", "cos", "tan", "asin", "acos", "atan", "sqrt", "log", "ln", "loge", "exp" };
+const int functionCount = sizeof(functionNames) / sizeof(functionNames[0]);
+
+int functionId(const string& name) {
+    for (int i = 0; i < functionCount; i++)
+        if (name == functionNames[i]) return i;
+    return -1;
+}
+
+double applyFunctionId(int id, double x, bool& ok) {
     ok = true;
-    if (name == "sin") return sin(x);
-    if (name == "cos") return cos(x);
-    if (name == "tan") return tan(x);
-    if (name == "asin") return asin(x);
-    if (name == "acos") return acos(x);
-    if (name == "atan") return atan(x);
-    if (name == "sqrt") {
+    switch (id) {
+    case 0: return sin(x);
+    case 1: return cos(x);
+    case 2: return tan(x);
+    case 3: return asin(x);
+    case 4: return acos(x);
+    case 5: return atan(x);
+    case 6:
         if (x < 0) { ok = false; return 0; }
         return sqrt(x);
-    }
-    if (name == "log") {
+    case 7:
         if (x <= 0) { ok = false; return 0; }
         return log10(x);
-    }
-    if (name == "ln" || name == "loge") {
+    case 8:
+    case 9:
         if (x <= 0) { ok = false; return 0; }
         return log(x);
+    case 10: return exp(x);
     }
-    if (name == "exp") return exp(x);
     ok = false; return 0;
 }
 
+double applyFunction(const string& name, double x, bool& ok) {
+    return applyFunctionId(functionId(name), x, ok);
+}
+
 int precedence(char op) {
     if (op == '+' || op == '-') return 1;
     if (op == '*' || op == '/') return 2;
@@ -68,13 +89,17 @@ bool isOperatorChar(char c) {
     return c == '+' || c == '-' || c == '*' || c == '/' || c == '^';
 }
 
-bool applyTopOperator(stack<double>& nums, stack<string>& ops, string& err) {
-    if (ops.empty()) { err = "ջ"; return false; }
-    string top = ops.top(); ops.pop();
-    if (top == "(") { err = "Ŵ"; return false; }
-    if (isOperatorChar(top[0]) && top.size() == 1) {
-        char op = top[0];
-        if (nums.size() < 2) { err = ""; return false; }
+// ĲһࣺValueStack ֵ߽ExprCompiler ͬĹԼ˳¼ɺ׺ָ
+// ߽ӿͬsize / pushNumber / isVariable / pushVariable / binary / call
+struct ValueStack {
+    stack<double> nums;
+
+    size_t size() const { return nums.size(); }
+    void pushNumber(double v) { nums.push(v); }
+    bool isVariable(const string&) const { return false; }
+    bool pushVariable(const string&, string&) { return false; }
+
+    bool binary(char op, string& err) {
         double b = nums.top(); nums.pop();
         double a = nums.top(); nums.pop();
         bool ok;
@@ -83,9 +108,8 @@ bool applyTopOperator(stack<double>& nums, stack<string>& ops, string& err) {
         nums.push(r);
         return true;
     }
-    else {
-        string fname = top;
-        if (nums.empty()) { err = "ȱٲ"; return false; }
+
+    bool call(const string& fname, string& err) {
         double x = nums.top(); nums.pop();
         bool ok;
         double r = applyFunction(fname, x, ok);
@@ -93,6 +117,21 @@ bool applyTopOperator(stack<double>& nums, stack<string>& ops, string& err) {
         nums.push(r);
         return true;
     }
+};
+
+template <class Operands>
+bool applyTopOperator(Operands& nums, stack<string>& ops, string& err) {
+    if (ops.empty()) { err = "ջ"; return false; }
+    string top = ops.top(); ops.pop();
+    if (top == "(") { err = "Ŵ"; return false; }
+    if (isOperatorChar(top[0]) && top.size() == 1) {
+        if (nums.size() < 2) { err = ""; return false; }
+        return nums.binary(top[0], err);
+    }
+    else {
+        if (nums.size() < 1) { err = "ȱٲ"; return false; }
+        return nums.call(top, err);
+    }
 }
 
 double strToDouble(const string& s) {
@@ -100,7 +139,8 @@ double strToDouble(const string& s) {
     catch (...) { return 0; }
 }
 
-bool handleOperatorPush(stack<double>& nums, stack<string>& ops, const string& op, string& err) {
+template <class Operands>
+bool handleOperatorPush(Operands& nums, stack<string>& ops, const string& op, string& err) {
     if (op == "(") {
         ops.push(op);
         return true;
@@ -136,8 +176,9 @@ bool handleOperatorPush(stack<double>& nums, stack<string>& ops, const string& o
     return true;
 }
 
-bool evaluateExpression(const string& expr, double& result, string& err) {
-    stack<double> nums;
+template <class Operands>
+bool parseExpression(const string& expr, Operands& nums, string& err) {
+    INSTR_SCOPE("parseExpression");
     stack<string> ops;
     map<string, double> constants;
     constants["pi"] = acos(-1.0);
@@ -153,7 +194,7 @@ bool evaluateExpression(const string& expr, double& result, string& err) {
             while (j < n && isDigitChar(expr[j])) j++;
             string numstr = expr.substr(i, j - i);
             double v = strToDouble(numstr);
-            nums.push(v);
+            nums.pushNumber(v);
             i = j;
             expectUnary = false;
             continue;
@@ -165,7 +206,10 @@ bool evaluateExpression(const string& expr, double& result, string& err) {
             string name_l = name;
             for (char& ch : name_l) ch = tolower((unsigned char)ch);
             if (constants.find(name_l) != constants.end()) {
-                nums.push(constants[name_l]);
+                nums.pushNumber(constants[name_l]);
+            }
+            else if (nums.isVariable(name_l)) {
+                if (!nums.pushVariable(name, err)) return false;
             }
             else {
                 ops.push(name_l);
@@ -188,7 +232,7 @@ bool evaluateExpression(const string& expr, double& result, string& err) {
         }
         if (isOperatorChar(c)) {
             if (c == '-' && expectUnary) {
-                nums.push(0);
+                nums.pushNumber(0);
             }
             string op(1, c);
             if (!handleOperatorPush(nums, ops, op, err)) return false;
@@ -204,15 +248,412 @@ bool evaluateExpression(const string& expr, double& result, string& err) {
         if (!applyTopOperator(nums, ops, err)) return false;
     }
     if (nums.size() != 1) { err = "ʽ"; return false; }
-    result = nums.top();
     return true;
 }
 
-int main() {
+bool evaluateExpression(const string& expr, double& result, string& err) {
+    ValueStack nums;
+    if (!parseExpression(expr, nums, err)) return false;
+    result = nums.nums.top();
+    return true;
+}
+
+// ===================== ʽ =====================
+
+// ĺ׺ָԼ˳
+struct Instr {
+    enum Kind { PUSH, LOAD, BINARY, CALL } kind;
+    char op;        // BINARY 
+    int arg;        // LOAD ƱţCALL ĺ
+    double value;   // PUSH ĳ
+};
+
+// ѱʽָУǳҲǺıʶã resolve ɱţ -1 ʾ޷ã
+struct ExprCompiler {
+    vector<Instr> code;
+    vector<int> refs;
+    int depth = 0;
+    function<int(const string&)> resolve;
+
+    size_t size() const { return depth; }
+    void pushNumber(double v) { code.push_back({ Instr::PUSH, 0, 0, v }); depth++; }
+    bool isVariable(const string& lower) const { return functionId(lower) < 0; }
+
+    bool pushVariable(const string& name, string& err) {
+        int id = resolve(name);
+        if (id < 0) { err = "δƣ" + name; return false; }
+        code.push_back({ Instr::LOAD, 0, id, 0 });
+        refs.push_back(id);
+        depth++;
+        return true;
+    }
+
+    bool binary(char op, string&) { code.push_back({ Instr::BINARY, op, 0, 0 }); depth--; return true; }
+
+    bool call(const string& fname, string& err) {
+        int id = functionId(fname);
+        if (id < 0) { err = "δ֪" + fname; return false; }
+        code.push_back({ Instr::CALL, 0, id, 0 });
+        return true;
+    }
+};
+
+// ִָУvalues ƱŸõֵ evaluateExpression λͬ
+bool runExpression(const vector<Instr>& code, const double* values, vector<double>& st, double& result, string& err) {
+    INSTR_SCOPE("runExpression");
+    st.clear();
+    for (const Instr& in : code) {
+        bool ok = true;
+        switch (in.kind) {
+        case Instr::PUSH: st.push_back(in.value); break;
+        case Instr::LOAD: st.push_back(values[in.arg]); break;
+        case Instr::BINARY: {
+            double b = st.back(); st.pop_back();
+            st.back() = applyBinary(st.back(), b, in.op, ok);
+            if (!ok) { err = (in.op == '/' ? "" : "Ԫʧ"); return false; }
+            break;
+        }
+        case Instr::CALL:
+            st.back() = applyFunctionId(in.arg, st.back(), ok);
+            if (!ok) { err = string("δ֪") + functionNames[in.arg]; return false; }
+            break;
+        }
+    }
+    result = st.back();
+    return true;
+}
+
+bool isIdentifier(const string& s) {
+    if (s.empty() || !isIdentStart(s[0])) return false;
+    for (char c : s) if (!isIdentChar(c)) return false;
+    return true;
+}
+
+// ӱʽʽϡÿƵĹʽһΣùϵ DAGdeps ָߣusers 򣩡
+// ޸ĳֻĴ߱ࣻȡֵʱֻΣrecomputeAll 㲢ȫ൥Ԫ
+// ʽ൥ԪҲ
+class FormulaModel {
+public:
+    // ¶ name = formulaδƻȽռλγɻĶ屻ܾұԭ
+    bool define(const string& name, const string& formula, string& err) {
+        if (!isIdentifier(name)) { err = "ƲϷ" + name; return false; }
+        string lower = name;
+        for (char& ch : lower) ch = tolower((unsigned char)ch);
+        if (lower == "pi" || lower == "e" || functionId(lower) >= 0) { err = "뺯" + name; return false; }
+
+        ExprCompiler comp;
+        comp.resolve = [this](const string& ref) { return idOf(ref); };
+        if (!parseExpression(formula, comp, err)) return false;
+        int c = idOf(name);
+        sort(comp.refs.begin(), comp.refs.end());
+        comp.refs.erase(unique(comp.refs.begin(), comp.refs.end()), comp.refs.end());
+        if (createsCycle(c, comp.refs)) { err = "ѭã" + name; return false; }
+        assign(c, formula, comp.code, comp.refs);
+        return true;
+    }
+
+    //  name Ϊ뵥Ԫ
+    void setValue(const string& name, double v) {
+        ostringstream os;
+        os.precision(17);
+        os << v;
+        vector<Instr> code(1, Instr{ Instr::PUSH, 0, 0, v });
+        vector<int> refs;
+        assign(idOf(name), os.str(), code, refs);
+    }
+
+    // ȡ name ĵǰֵֻε൥Ԫ
+    bool value(const string& name, double& result, string& err) {
+        auto it = ids.find(name);
+        if (it == ids.end()) { err = "δƣ" + name; return false; }
+        refresh(it->second);
+        const Cell& cell = cells[it->second];
+        if (!cell.ok) { err = cell.err; return false; }
+        result = values[it->second];
+        return true;
+    }
+
+    // һƵʱʽ
+    bool evaluate(const string& expr, double& result, string& err) {
+        ExprCompiler comp;
+        comp.resolve = [this](const string& ref) {
+            auto it = ids.find(ref);
+            return it == ids.end() || !cells[it->second].defined ? -1 : it->second;
+        };
+        if (!parseExpression(expr, comp, err)) return false;
+        for (int d : comp.refs) {
+            refresh(d);
+            if (!cells[d].ok) { err = "õ " + cells[d].name + " Ч" + cells[d].err; return false; }
+        }
+        return runExpression(comp.code, values.data(), scratch, result, err);
+    }
+
+    // ˲൥Ԫͬһ㻥Ԫ㹻ʱָ threads ߳
+    void recomputeAll(int threads = 1) {
+        vector<int> level, next;
+        for (int c = 0; c < (int)cells.size(); c++) {
+            if (!cells[c].dirty) continue;
+            int p = 0;
+            for (int d : cells[c].deps) p += cells[d].dirty;
+            pending[c] = p;
+            if (p == 0) level.push_back(c);
+        }
+        vector<vector<double>> stacks(max(1, threads));
+        while (!level.empty()) {
+            int t = (threads > 1 && level.size() >= 4096) ? threads : 1;
+            if (t == 1) {
+                for (int c : level) recompute(c, stacks[0]);
+            }
+            else {
+                vector<thread> pool;
+                size_t chunk = (level.size() + t - 1) / t;
+                for (int k = 0; k < t; k++)
+                    pool.push_back(thread([&, k] {
+                        size_t b = k * chunk, e = min(level.size(), b + chunk);
+                        for (size_t i = b; i < e; i++) recompute(level[i], stacks[k]);
+                    }));
+                for (auto& th : pool) th.join();
+            }
+            next.clear();
+            for (int c : level)
+                for (int u : cells[c].users)
+                    if (--pending[u] == 0) next.push_back(u);
+            level.swap(next);
+        }
+    }
+
+    int dirtyCount() const {
+        int k = 0;
+        for (const Cell& c : cells) k += c.dirty;
+        return k;
+    }
+
+    bool isDirty(const string& name) const {
+        auto it = ids.find(name);
+        return it != ids.end() && cells[it->second].dirty;
+    }
+
+    size_t size() const { return cells.size(); }
+
+private:
+    struct Cell {
+        string name, formula;
+        vector<Instr> code;
+        vector<int> deps, users;
+        bool defined = false, dirty = true, ok = false;
+        string err;
+    };
+
+    vector<Cell> cells;
+    vector<double> values;
+    vector<int> pending;   // recomputeAll δ
+    vector<int> mark;      // õʱ
+    int epoch = 0;
+    unordered_map<string, int> ids;
+    vector<double> scratch;
+
+    int idOf(const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = (int)cells.size();
+        ids[name] = id;
+        cells.push_back(Cell());
+        cells.back().name = name;
+        values.push_back(0);
+        pending.push_back(0);
+        mark.push_back(0);
+        return id;
+    }
+
+    // 滻 c Ķ岢
+    void assign(int c, const string& formula, vector<Instr>& code, vector<int>& refs) {
+        Cell& cell = cells[c];
+        for (int d : cell.deps) {
+            vector<int>& us = cells[d].users;
+            us.erase(find(us.begin(), us.end(), c));
+        }
+        for (int d : refs) cells[d].users.push_back(c);
+        cell.deps.swap(refs);
+        cell.code.swap(code);
+        cell.formula = formula;
+        cell.defined = true;
+        markDirty(c);
+    }
+
+    // c  refs Ƿɻrefs  c ĳ ref Ѿݵأ c
+    bool createsCycle(int c, const vector<int>& refs) {
+        if (refs.empty()) return false;
+        epoch++;
+        vector<int> st(1, c);
+        mark[c] = epoch;
+        while (!st.empty()) {
+            int v = st.back(); st.pop_back();
+            for (int u : cells[v].users)
+                if (mark[u] != epoch) { mark[u] = epoch; st.push_back(u); }
+        }
+        for (int d : refs)
+            if (mark[d] == epoch) return true;
+        return false;
+    }
+
+    //  c Ĵ߱ࣻĵԪͣΰʽ
+    void markDirty(int c) {
+        cells[c].dirty = true;
+        vector<int> st(cells[c].users.begin(), cells[c].users.end());
+        while (!st.empty()) {
+            int v = st.back(); st.pop_back();
+            if (cells[v].dirty) continue;
+            cells[v].dirty = true;
+            st.insert(st.end(), cells[v].users.begin(), cells[v].users.end());
+        }
+    }
+
+    //  c ε൥Ԫ㣬
+    void refresh(int c) {
+        if (!cells[c].dirty) return;
+        epoch++;
+        vector<pair<int, size_t>> st;
+        st.push_back({ c, 0 });
+        mark[c] = epoch;
+        while (!st.empty()) {
+            int v = st.back().first;
+            size_t& k = st.back().second;
+            const vector<int>& deps = cells[v].deps;
+            while (k < deps.size() && (!cells[deps[k]].dirty || mark[deps[k]] == epoch)) k++;
+            if (k < deps.size()) {
+                int d = deps[k];
+                mark[d] = epoch;
+                st.push_back({ d, 0 });
+            }
+            else {
+                recompute(v, scratch);
+                st.pop_back();
+            }
+        }
+    }
+
+    // ʱ c
+    void recompute(int c, vector<double>& st) {
+        Cell& cell = cells[c];
+        cell.dirty = false;
+        cell.ok = false;
+        if (!cell.defined) { cell.err = "δƣ" + cell.name; return; }
+        for (int d : cell.deps)
+            if (!cells[d].ok) { cell.err = "õ " + cells[d].name + " Ч"; return; }
+        double v;
+        if (runExpression(cell.code, values.data(), st, v, cell.err)) {
+            values[c] = v;
+            cell.ok = true;
+        }
+    }
+};
+
+// ===================== ܲ =====================
+
+// ģ n / 1000 Źÿű 1000 ʽԪ f*  inputs / (n / 1000) 뵥Ԫ x*
+// ʽñĵԪ򱾱룬x0 ΪбõĲʣԼ 1000 
+void buildModel(FormulaModel& model, int n, int inputs, const vector<double>& inputValues, unsigned seed) {
+    mt19937 rng(seed);
+    int sheets = max(1, n / 1000), perSheet = max(1, inputs / sheets);
+    auto pick = [&](int i) {
+        int g = i / 1000, lo = g * 1000;
+        if (rng() % 500 == 0) return string("x0");
+        if (i == lo || rng() % 4 == 0) return "x" + to_string(min(inputs - 1, g * perSheet + (int)(rng() % perSheet)));
+        return "f" + to_string(lo + (int)(rng() % (i - lo)));
+    };
+    for (int k = 0; k < inputs; k++) model.setValue("x" + to_string(k), inputValues[k]);
+    string err;
+    for (int i = 0; i < n; i++) {
+        string a = pick(i), b = pick(i), c = pick(i);
+        string f = (i % 2) ? "0.5*" + a + " + sin(" + b + ") - " + c + "/3"
+            : "sqrt(" + a + "*" + a + " + 1) * 0.25 + cos(" + b + " - " + c + ")";
+        model.define("f" + to_string(i), f, err);
+    }
+}
+
+void benchModel(int n, int inputs) {
+    int threads = max(1u, thread::hardware_concurrency());
+    mt19937 rng(7);
+    vector<double> in(inputs);
+    for (double& v : in) v = (rng() % 1000) / 100.0;
+
+    auto ms = [](chrono::high_resolution_clock::time_point a, chrono::high_resolution_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    FormulaModel model;
+    auto t0 = chrono::high_resolution_clock::now();
+    buildModel(model, n, inputs, in, 1);
+    auto t1 = chrono::high_resolution_clock::now();
+    model.recomputeAll(1);
+    auto t2 = chrono::high_resolution_clock::now();
+    cout << n << " ʽ + " << inputs << "  | (ms): " << ms(t0, t1) << " | ȫ(ms): " << ms(t1, t2) << endl;
+
+    // ޸һ룺ֻĴ
+    for (int k : { 503, 0 }) {
+        in[k] += 1;
+        model.setValue("x" + to_string(k), in[k]);
+        int dirty = model.dirtyCount();
+        t0 = chrono::high_resolution_clock::now();
+        model.recomputeAll(1);
+        t1 = chrono::high_resolution_clock::now();
+        cout << "޸ x" << k << " | ൥Ԫ: " << dirty << " | (ms): " << ms(t0, t1) << endl;
+    }
+
+    // ȡֵֻ㱻ѯԪΣѯ๫ʽ֤ȡȷʵ
+    in[0] -= 2;
+    model.setValue("x0", in[0]);
+    int target = n - 1;
+    while (target > 0 && !model.isDirty("f" + to_string(target))) target--;
+    string name = "f" + to_string(target);
+    int before = model.dirtyCount();
+    double v;
+    string err;
+    t0 = chrono::high_resolution_clock::now();
+    model.value(name, v, err);
+    t1 = chrono::high_resolution_clock::now();
+    int after = model.dirtyCount();
+    cout << "޸ x0 Զȡ " << name << "(ms): " << ms(t0, t1) << " | 㵥Ԫ: " << before - after
+        << " | ΪĵԪ: " << after << endl;
+    model.recomputeAll(1);
+
+    // ޸ȫ룬Ƚϵ̵߳߳ķֲ
+    double serial = 0, parallel = 0;
+    for (int round = 0; round < 2; round++) {
+        for (int k = 0; k < inputs; k++) { in[k] += 0.5; model.setValue("x" + to_string(k), in[k]); }
+        t0 = chrono::high_resolution_clock::now();
+        model.recomputeAll(round == 0 ? 1 : threads);
+        t1 = chrono::high_resolution_clock::now();
+        (round == 0 ? serial : parallel) = ms(t0, t1);
+    }
+    cout << "޸ȫ | ߳(ms): " << serial << " | " << threads << " ߳(ms): " << parallel << endl;
+
+    // ͬͷģȫ㣬ȶ
+    FormulaModel fresh;
+    buildModel(fresh, n, inputs, in, 1);
+    fresh.recomputeAll(1);
+    bool ok = true;
+    for (int i = 0; i < n && ok; i++) {
+        double a = 0, b = 0;
+        string ea, eb;
+        bool okA = model.value("f" + to_string(i), a, ea), okB = fresh.value("f" + to_string(i), b, eb);
+        ok = okA == okB && (!okA || memcmp(&a, &b, sizeof a) == 0);
+    }
+    cout << "У: " << (ok ? "һ" : "һ") << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "bench") {
+        benchModel(200000, 1000);
+        return 0;
+    }
+
     cout.setf(std::ios::fixed);
     cout.precision(10);
     string line;
+    FormulaModel model;
     cout << "ʽ֧ + - * / ^ ţԼ sin cos tan log ln sqrt exp ͳ pi e quit ˳" << endl;
+    cout << "  = ʽ 幫ʽʽͱʽпѶƣ޸ĶĹʽԶ¡" << endl;
     while (true) {
         cout << "> ";
         if (!getline(cin, line)) break;
@@ -220,7 +661,17 @@ int main() {
         if (line == "quit" || line == "exit") break;
         double ans;
         string err;
-        bool ok = evaluateExpression(line, ans, err);
+        size_t eq = line.find('=');
+        if (eq != string::npos) {
+            string name = line.substr(0, eq);
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+            if (!model.define(name, line.substr(eq + 1), err)) { cout << "Ч" << err << endl; continue; }
+            if (model.value(name, ans, err)) cout << name << " = " << ans << endl;
+            else cout << name << " ʱ޷㣺" << err << endl;
+            continue;
+        }
+        bool ok = model.evaluate(line, ans, err);
         if (ok) cout << "ǣ" << ans << endl;
         else cout << "ʽЧ" << err << endl;
     }
@@ -1,10 +1,21 @@
 #include <iostream>
 #include <vector>
 #include <stack>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cstdlib>
 
+#include "../common/instrument.h"
 using namespace std;
 
 long long getMaxArea(const vector<int>& h) {
+    INSTR_SCOPE("getMaxArea");
     int n = h.size();
     stack<int> s;
     long long maxArea = 0;
@@ -24,10 +35,472 @@ long long getMaxArea(const vector<int>& h) {
     return maxArea;
 }
 
-int main() {
+// ===================== βѯ =====================
+
+// ɭ"㵽"·ѯÿֱ y = k*x + b·ֱ x ֵ
+// ʷְ· O(log n) ϵ䣻߶ÿ㱣ֱߵϰ磬
+// ֻ x  [0, xmax] ĳϿϸȡֱߣжֵֻȽϡ
+// βѯ O(log^3 n)ڴ棺ֱ 16 ֽ * ֱÿ߶İֱ
+// ± O(n log n)  intʵʼ֦ԶСڴˣ10^6 㡢ÿ 2 ֱʱԼ 4.7M ±꣨19 MB
+class PathLineMax {
+public:
+    struct Line {
+        long long k, b;
+        long long at(long long x) const { return k * x + b; }
+    };
+
+    // parent[v] Ϊ -1 ʾnodeLines е v * perNode  perNode ֱڽ v
+    // nodeLines ӹܺԭذʷλţ÷ֵʱһֱ
+    void build(const vector<int>& parent, vector<Line> nodeLines, int perNode, long long xmaxValue) {
+        n = parent.size();
+        xmax = xmaxValue;
+        par = parent;
+        decompose();
+
+        size = 1;
+        while (size < n) size *= 2;
+        vector<int> buf;
+        start.assign(2 * size + 1, 0);
+        count.assign(2 * size, 0);
+        hull.clear();
+        lines = move(nodeLines);
+        permuteLines(perNode);
+        for (int i = 0; i < n; i++) {
+            buf.clear();
+            for (int j = 0; j < perNode; j++) buf.push_back(i * perNode + j);
+            sort(buf.begin(), buf.end(), [&](int a, int b) { return byK(a, b); });
+            store(size + i, buf);
+        }
+        for (int node = size - 1; node >= 1; node--) {
+            int a = 2 * node, b = 2 * node + 1;
+            buf.resize(count[a] + count[b]);
+            merge(hull.begin() + start[a], hull.begin() + start[a] + count[a],
+                hull.begin() + start[b], hull.begin() + start[b] + count[b], buf.begin(),
+                [&](int x, int y) { return byK(x, y); });
+            store(node, buf);
+        }
+    }
+
+    // v ظָ뵽 stop stop·ϣֱ x ֵ·Ϊշ LLONG_MIN
+    long long query(int v, int stop, long long x) const {
+        long long best = LLONG_MIN;
+        while (head[v] != head[stop]) {
+            best = max(best, rangeQuery(pos[head[v]], pos[v], x));
+            v = par[head[v]];
+        }
+        if (v != stop) best = max(best, rangeQuery(pos[stop] + 1, pos[v], x));
+        return best;
+    }
+
+private:
+    int n = 0, size = 1;
+    long long xmax = 0;
+    vector<int> par, head, pos;
+    vector<Line> lines;          // ʷλ
+    vector<int> hull, start, count;
+
+    bool byK(int a, int b) const {
+        return lines[a].k != lines[b].k ? lines[a].k < lines[b].k : lines[a].b < lines[b].b;
+    }
+
+    //  v ֱ߿ᵽλ pos[v]ûĻ齻ֻһݴ
+    void permuteLines(int perNode) {
+        vector<char> placed(n, 0);
+        vector<Line> carry(perNode);
+        for (int v = 0; v < n; v++) {
+            if (placed[v]) continue;
+            copy(lines.begin() + (size_t)v * perNode, lines.begin() + (size_t)(v + 1) * perNode, carry.begin());
+            placed[v] = 1;
+            // carry ǽ u ֱߣŵ pos[u]ԭռŸλõĽֱ
+            for (int u = v; pos[u] != v; ) {
+                int t = pos[u];
+                swap_ranges(carry.begin(), carry.end(), lines.begin() + (size_t)t * perNode);
+                placed[t] = 1;
+                u = t;
+            }
+            copy(carry.begin(), carry.end(), lines.begin() + (size_t)v * perNode);
+        }
+    }
+
+    // ʷ֣ϵĽλͷλС
+    void decompose() {
+        vector<int> childStart(n + 1, 0), children(n), sz(n, 1), heavy(n, -1), order;
+        for (int v = 0; v < n; v++) if (par[v] >= 0) childStart[par[v] + 1]++;
+        for (int v = 0; v < n; v++) childStart[v + 1] += childStart[v];
+        vector<int> fill(childStart.begin(), childStart.end() - 1);
+        for (int v = 0; v < n; v++) if (par[v] >= 0) children[fill[par[v]]++] = v;
+
+        order.reserve(n);
+        for (int v = 0; v < n; v++) if (par[v] < 0) order.push_back(v);
+        for (size_t i = 0; i < order.size(); i++)
+            for (int c = childStart[order[i]]; c < childStart[order[i] + 1]; c++) order.push_back(children[c]);
+        for (int i = n - 1; i >= 0; i--) {
+            int v = order[i], p = par[v];
+            if (p < 0) continue;
+            sz[p] += sz[v];
+            if (heavy[p] < 0 || sz[v] > sz[heavy[p]]) heavy[p] = v;
+        }
+
+        head.assign(n, 0);
+        pos.assign(n, 0);
+        int next = 0;
+        vector<int> heads;
+        for (int v = 0; v < n; v++) if (par[v] < 0) heads.push_back(v);
+        while (!heads.empty()) {
+            int h = heads.back();
+            heads.pop_back();
+            for (int v = h; v >= 0; v = heavy[v]) {
+                head[v] = h;
+                pos[v] = next++;
+                for (int c = childStart[v]; c < childStart[v + 1]; c++)
+                    if (children[c] != heavy[v]) heads.push_back(children[c]);
+            }
+        }
+    }
+
+    static long long floorDiv(long long a, long long b) {
+        long long q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+
+    // k  abc ֱУb  [0, xmax] ÿ϶ max(a, c) ʱɾȥ
+    // b - max(a, c) ǰ ac ȡֻ
+    bool redundant(const Line& a, const Line& b, const Line& c) const {
+        long long x0 = min(xmax, max(0LL, floorDiv(a.b - c.b, c.k - a.k)));
+        long long x1 = min(xmax, x0 + 1);
+        return b.at(x0) <= max(a.at(x0), c.at(x0)) && b.at(x1) <= max(a.at(x1), c.at(x1));
+    }
+
+    // buf Ѱ k ϰд hull
+    void store(int node, const vector<int>& buf) {
+        start[node] = hull.size();
+        for (int id : buf) {
+            const Line& L = lines[id];
+            int base = start[node];
+            int cnt = (int)hull.size() - base;
+            if (cnt > 0 && lines[hull.back()].k == L.k) { hull.pop_back(); cnt--; }
+            // Ҷ˵㶼򴦴бʸ󣩣
+            if (cnt > 0 && L.at(xmax) <= lines[hull.back()].at(xmax)) continue;
+            // ԭĩβ˵㶼ߴ򴦴ߴɾȥ
+            while (cnt > 0 && lines[hull.back()].at(0) <= L.at(0)) { hull.pop_back(); cnt--; }
+            while (cnt >= 2 && redundant(lines[hull[hull.size() - 2]], lines[hull.back()], L)) { hull.pop_back(); cnt--; }
+            hull.push_back(id);
+        }
+        count[node] = (int)hull.size() - start[node];
+    }
+
+    long long hullMax(int node, long long x) const {
+        int lo = start[node], hi = start[node] + count[node] - 1;
+        if (lo > hi) return LLONG_MIN;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (lines[hull[mid]].at(x) < lines[hull[mid + 1]].at(x)) lo = mid + 1;
+            else hi = mid;
+        }
+        return lines[hull[lo]].at(x);
+    }
+
+    long long rangeQuery(int l, int r, long long x) const {
+        long long best = LLONG_MIN;
+        for (l += size, r += size + 1; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) best = max(best, hullMax(l++, x));
+            if (r & 1) best = max(best, hullMax(--r, x));
+        }
+        return best;
+    }
+};
+
+// ͬһ߶Ϸѯ" [l, r] ڵ"
+// ÿιߵ tt Ϊ [pse(t) + 1, nse(t) - 1]pse ΪĲӣ
+// nse ΪҲϸӣ A_tѯ [l, r] ʱ m ΪСֵ
+//   - m  h_m * (r - l + 1)
+//   - [l, m) ڵҪô l  nse ߵ m ϣ l ضϣ h_c * (nse(c) - l) l һκ
+//     Ҫô֮䣬ȫڣ A_tÿԤȡε A_t
+//   - (m, r] ˶Գƣ pse  r ߵ mضϹ h_e * (r - pse(e))
+// ֱ nse ɭֺ pse ɭϵ m · PathLineMax ѯ
+// ڴС O(n)  O(n log n) ֮䣺10^6 ʵ⽨úפԼ 180-240 MB
+// ֱ߸ 32 MB± 20-55 MB߶ʷԼ 60 MBṹʱֵԼ 210-260 MB
+class RangeMaxRect {
+public:
+    explicit RangeMaxRect(const vector<int>& heights) : h(heights) {
+        int n = h.size();
+        vector<int> pse(n), nse(n);
+        vector<int> st;
+        for (int i = 0; i < n; i++) {
+            while (!st.empty() && h[st.back()] > h[i]) st.pop_back();
+            pse[i] = st.empty() ? -1 : st.back();
+            st.push_back(i);
+        }
+        st.clear();
+        for (int i = n - 1; i >= 0; i--) {
+            while (!st.empty() && h[st.back()] >= h[i]) st.pop_back();
+            nse[i] = st.empty() ? n : st.back();
+            st.push_back(i);
+        }
+
+        // Сֵ±߶
+        size = 1;
+        while (size < max(n, 1)) size *= 2;
+        minTree.assign(2 * size, -1);
+        for (int i = 0; i < n; i++) minTree[size + i] = i;
+        for (int i = size - 1; i >= 1; i--) minTree[i] = better(minTree[2 * i], minTree[2 * i + 1]);
+
+        vector<int> leftParent(n), rightParent(n);
+        vector<PathLineMax::Line> leftLines(2 * n), rightLines(2 * n);
+        {
+            // A_t ֵ߶ֱֻʱãǰͷ
+            vector<long long> maxTree(2 * size, 0);
+            for (int i = 0; i < n; i++) maxTree[size + i] = (long long)h[i] * (nse[i] - pse[i] - 1);
+            for (int i = size - 1; i >= 1; i--) maxTree[i] = max(maxTree[2 * i], maxTree[2 * i + 1]);
+            auto maxArea = [&](int l, int r) {
+                long long best = 0;
+                for (l += size, r += size + 1; l < r; l >>= 1, r >>= 1) {
+                    if (l & 1) best = max(best, maxTree[l++]);
+                    if (r & 1) best = max(best, maxTree[--r]);
+                }
+                return best;
+            };
+            for (int i = 0; i < n; i++) {
+                leftParent[i] = nse[i] < n ? nse[i] : -1;
+                leftLines[2 * i] = { -(long long)h[i], (long long)h[i] * nse[i] };
+                leftLines[2 * i + 1] = { 0, nse[i] - i > 1 ? maxArea(i + 1, nse[i] - 1) : 0 };
+                rightParent[i] = pse[i];
+                rightLines[2 * i] = { (long long)h[i], -(long long)h[i] * pse[i] };
+                rightLines[2 * i + 1] = { 0, i - pse[i] > 1 ? maxArea(pse[i] + 1, i - 1) : 0 };
+            }
+        }
+        vector<int>().swap(pse);
+        vector<int>().swap(nse);
+        left.build(leftParent, move(leftLines), 2, max(0, n - 1));
+        right.build(rightParent, move(rightLines), 2, max(0, n - 1));
+    }
+
+    //  [l, r]0 𣬱䣩ڵ
+    long long query(int l, int r) const {
+        int m = argmin(l, r);
+        long long best = (long long)h[m] * (r - l + 1);
+        best = max(best, left.query(l, m, l));
+        best = max(best, right.query(r, m, r));
+        return best;
+    }
+
+private:
+    vector<int> h;
+    int size = 1;
+    vector<int> minTree;
+    PathLineMax left, right;
+
+    int better(int a, int b) const {
+        if (a < 0) return b;
+        if (b < 0) return a;
+        return h[b] < h[a] || (h[b] == h[a] && b < a) ? b : a;
+    }
+
+    int argmin(int l, int r) const {
+        int best = -1;
+        for (l += size, r += size + 1; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) best = better(best, minTree[l++]);
+            if (r & 1) best = better(best, minTree[--r]);
+        }
+        return best;
+    }
+};
+
+// ===================== ݲд =====================
+
+struct TestCase {
+    int n;
+    vector<int> h;
+};
+
+// ģʽĸʽȫ飨ʾ߶ͬضϵ [0, 10000]
+vector<TestCase> readCases(istream& in) {
+    vector<TestCase> cases;
+    int T;
+    if (!(in >> T)) return cases;
+    for (int t = 0; t < T; t++) {
+        TestCase c;
+        if (!(in >> c.n)) break;
+        if (c.n > 0) {
+            c.h.resize(c.n);
+            for (int i = 0; i < c.n; i++) {
+                int x = 0;
+                in >> x;
+                c.h[i] = min(max(x, 0), 10000);
+            }
+        }
+        cases.push_back(move(c));
+    }
+    return cases;
+}
+
+string formatCase(const TestCase& c) {
+    ostringstream out;
+    if (c.n <= 0) {
+        out << "n 0\n";
+        return out.str();
+    }
+    out << "ĸ߶Ϊ: [";
+    for (int i = 0; i < c.n; i++) {
+        out << c.h[i];
+        if (i != c.n - 1) out << ", ";
+    }
+    out << "]\n";
+    out << "=" << getMaxArea(c.h) << "\n";
+    out << "-----------------------\n";
+    return out.str();
+}
+
+// ̴߳ӹȡһ飬Ŵţ˳
+void processCases(const vector<TestCase>& cases, ostream& out, int threads) {
+    vector<string> results(cases.size());
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < cases.size();) results[i] = formatCase(cases[i]);
+    };
+    threads = max(1, min(threads, (int)cases.size()));
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    for (const string& r : results) out << r;
+}
+
+int hardwareThreads() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+// ===================== ܲ =====================
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+long long stackQuery(const vector<int>& h, int l, int r) {
+    return getMaxArea(vector<int>(h.begin() + l, h.begin() + r + 1));
+}
+
+// ״СϣܵջĽȫȶ
+bool checkRangeQueries() {
+    mt19937 rng(7);
+    for (int it = 0; it < 500; it++) {
+        int n = 1 + rng() % 80;
+        vector<int> h(n);
+        for (int i = 0; i < n; i++) {
+            switch (it % 5) {
+            case 0: h[i] = rng() % 4; break;
+            case 1: h[i] = i; break;
+            case 2: h[i] = n - i; break;
+            case 3: h[i] = (i % 7) * (rng() % 3); break;
+            default: h[i] = rng() % 10001; break;
+            }
+        }
+        RangeMaxRect q(h);
+        for (int l = 0; l < n; l++)
+            for (int r = l; r < n; r++)
+                if (q.query(l, r) != stackQuery(h, l, r)) return false;
+    }
+    return true;
+}
+
+void benchRangeQueries(int n, int queries) {
+    mt19937 rng(2024);
+    const char* names[] = { "", "", "" };
+    for (int kind = 0; kind < 3; kind++) {
+        vector<int> h(n);
+        for (int i = 0; i < n; i++)
+            h[i] = kind == 0 ? rng() % 10001 : kind == 1 ? (int)((long long)i * 10000 / n) : i % 1000 * 10;
+
+        auto t0 = chrono::steady_clock::now();
+        RangeMaxRect q(h);
+        double buildMs = elapsedMs(t0);
+
+        vector<pair<int, int>> qs(queries);
+        for (auto& p : qs) {
+            int a = rng() % n, b = rng() % n;
+            p = { min(a, b), max(a, b) };
+        }
+        long long checksum = 0;
+        t0 = chrono::steady_clock::now();
+        for (auto& p : qs) checksum += q.query(p.first, p.second);
+        double queryMs = elapsedMs(t0);
+
+        // ջѯֻ̫ǰһֲ
+        int sample = min(queries, 200);
+        bool same = true;
+        t0 = chrono::steady_clock::now();
+        for (int i = 0; i < sample; i++)
+            same = same && stackQuery(h, qs[i].first, qs[i].second) == q.query(qs[i].first, qs[i].second);
+        double stackMs = elapsedMs(t0) / sample * queries;
+
+        cout << names[kind] << " n=" << n << ", Ԥ " << buildMs << " ms, " << queries << " βѯ " << queryMs
+             << " ms (У " << checksum << "), ջ " << stackMs << " ms,  "
+             << stackMs / queryMs << " , У: " << (same ? "һ" : "һ") << "\n";
+    }
+}
+
+// ֻۼ FNV-1a ɢкֽ壬ȶԴʱذıڴ
+class HashStreamBuf : public streambuf {
+public:
+    unsigned long long hash = 14695981039346656037ULL, bytes = 0;
+
+protected:
+    int overflow(int c) override {
+        if (c != EOF) mix((char)c);
+        return c == EOF ? 0 : c;
+    }
+    streamsize xsputn(const char* s, streamsize n) override {
+        for (streamsize i = 0; i < n; i++) mix(s[i]);
+        return n;
+    }
+
+private:
+    void mix(char c) {
+        hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+        bytes++;
+    }
+};
+
+void benchCases(int T, int n) {
+    // ֱɲ飬ıı ostringstreamstr()  istringstream һ
+    mt19937 rng(99);
+    vector<TestCase> cases(T);
+    for (TestCase& c : cases) {
+        c.n = n;
+        c.h.resize(n);
+        for (int& x : c.h) x = rng() % 10001;
+    }
+
+    HashStreamBuf serialBuf, parallelBuf;
+    ostream serial(&serialBuf), parallel(&parallelBuf);
+    auto t0 = chrono::steady_clock::now();
+    processCases(cases, serial, 1);
+    double serialMs = elapsedMs(t0);
+    int threads = hardwareThreads();
+    t0 = chrono::steady_clock::now();
+    processCases(cases, parallel, threads);
+    double parallelMs = elapsedMs(t0);
+    cout << T << "  x " << n << " : ߳ " << serialMs << " ms, " << threads << " ߳ " << parallelMs
+         << " ms, У: " << (serialBuf.hash == parallelBuf.hash && serialBuf.bytes == parallelBuf.bytes ? "һ" : "һ") << "\n";
+}
+
+int main(int argc, char* argv[]) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
+    if (argc > 1 && string(argv[1]) == "bench") {
+        cout << "ѯСģȫȶ, У: " << (checkRangeQueries() ? "һ" : "һ") << "\n";
+        benchRangeQueries(1000000, 100000);
+        benchCases(400, 50000);
+        return 0;
+    }
+    // 뽻ģʽͬʽʾ̼߳㡢˳
+    if (argc > 1 && string(argv[1]) == "batch") {
+        int threads = argc > 2 ? atoi(argv[2]) : hardwareThreads();
+        processCases(readCases(cin), cout, threads);
+        return 0;
+    }
+
     int T;
     cout << ": ";
     if (!(cin >> T)) return 0;
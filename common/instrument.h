@@ -0,0 +1,427 @@
+// ======================= ·׮׷ =======================
+// ʵõĽͷļ׮⣺
+//   INSTR_SCOPE("")      ʱʱ룩ֱͬͼ׷ʱһ׷¼
+//   INSTR_COUNT("", n)    n
+//   INSTR_HIST("", v)    ѷǸ v ֱͼ
+// ͳư̷ֿ߳ţÿֻ߳дԼһݣrelaxed ԭӶдԭӼӣʱӡ
+// ʱɻĬϹرգʱÿ׮ֻһξ̬ʼһβжϣ
+//   INSTRUMENT=1             ͳƣ˳ʱѻܱӡ stderr
+//   INSTRUMENT_TRACE=ļ   ͬʱͳƣ˳ʱ¼Ϊ Chrome trace-event JSON
+//                            chrome://tracing  Perfetto 򿪣
+//   INSTRUMENT_PERF=1        Linux  perf_event_open  cycles / cache misses / branch misses
+// ʱ INSTRUMENT_DISABLED кչΪա
+//  ASCIIԴļشҳ棬 ASCII д JSON Ч UTF-8
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace instrument {
+
+enum SiteKind { SITE_SCOPE, SITE_COUNTER, SITE_HISTOGRAM };
+enum PerfEvent { PERF_CYCLES, PERF_CACHE_MISSES, PERF_BRANCH_MISSES, PERF_EVENT_COUNT };
+
+const int MAX_SITES = 64;
+const int HIST_BUCKETS = 256;
+const size_t MAX_TRACE_EVENTS = 1 << 20;   // ÿ߳ౣ׷¼ֻ
+
+// -ԷͰ0..3 ռһͰ֮ÿ 2 پ 4  25%
+inline int floorLog2(uint64_t v) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return (int)i;
+#elif defined(_MSC_VER)
+    int r = 0;
+    while (v >>= 1) r++;
+    return r;
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+inline int bucketOf(uint64_t v) {
+    if (v < 4) return (int)v;
+    int lg = floorLog2(v);
+    return 4 * (lg - 1) + (int)((v >> (lg - 2)) & 3);
+}
+
+//  b ͰСֵ
+inline uint64_t bucketLow(int b) {
+    if (b < 4) return (uint64_t)b;
+    int lg = b / 4 + 1;
+    return (uint64_t)(4 + b % 4) << (lg - 2);
+}
+
+// ֻ߳дĵԪrelaxed д̲߳ȡҲݾ
+struct Cell {
+    std::atomic<uint64_t> v{ 0 };
+
+    void add(uint64_t d) { v.store(v.load(std::memory_order_relaxed) + d, std::memory_order_relaxed); }
+    void raise(uint64_t x) { if (x > v.load(std::memory_order_relaxed)) v.store(x, std::memory_order_relaxed); }
+    uint64_t get() const { return v.load(std::memory_order_relaxed); }
+};
+
+struct SiteStats {
+    Cell count, sum, maxValue;
+    Cell perf[PERF_EVENT_COUNT];
+    Cell hist[HIST_BUCKETS];
+};
+
+struct TraceEvent {
+    int site;
+    uint64_t start, duration;   // 룬עʱ
+};
+
+// һ̵߳ȫͳơעУ߳˳Ա̽
+struct ThreadData {
+    int tid = 0;
+    SiteStats sites[MAX_SITES];
+    std::vector<TraceEvent> trace;
+    uint64_t droppedEvents = 0;
+    int perfFd[PERF_EVENT_COUNT] = { -1, -1, -1 };
+
+    ~ThreadData() {
+#ifdef __linux__
+        for (int fd : perfFd) if (fd >= 0) close(fd);
+#endif
+    }
+};
+
+// ---------- perf_event_openӲһ飬һ read  ----------
+#ifdef __linux__
+inline bool openPerf(ThreadData& t) {
+    static const uint64_t configs[PERF_EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+        perf_event_attr a;
+        memset(&a, 0, sizeof(a));
+        a.size = sizeof(a);
+        a.type = PERF_TYPE_HARDWARE;
+        a.config = configs[i];
+        a.disabled = i == 0;
+        a.exclude_kernel = 1;
+        a.exclude_hv = 1;
+        a.read_format = PERF_FORMAT_GROUP;
+        long fd = syscall(__NR_perf_event_open, &a, 0, -1, i == 0 ? -1 : t.perfFd[0], 0);
+        if (fd < 0) {
+            for (int k = 0; k < i; k++) { close(t.perfFd[k]); t.perfFd[k] = -1; }
+            return false;
+        }
+        t.perfFd[i] = (int)fd;
+    }
+    ioctl(t.perfFd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+inline bool readPerf(const ThreadData& t, uint64_t out[PERF_EVENT_COUNT]) {
+    if (t.perfFd[0] < 0) return false;
+    uint64_t buf[1 + PERF_EVENT_COUNT];
+    if (read(t.perfFd[0], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) return false;
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) out[i] = buf[1 + i];
+    return true;
+}
+#else
+inline bool openPerf(ThreadData&) { return false; }
+inline bool readPerf(const ThreadData&, uint64_t*) { return false; }
+#endif
+
+// ---------- ȫע׮ơ߳ݡʱ ----------
+class Registry {
+public:
+    bool enabled = false, tracing = false, perf = false;
+    std::string tracePath;
+
+    static Registry& get() {
+        static Registry r;
+        return r;
+    }
+
+    // Ǽǲ׮㣬ͬͬ෵ͬһţ׮㳬 MAX_SITES ʱ -1õ㲻ͳ
+    int site(const char* name, SiteKind kind) {
+        std::lock_guard<std::mutex> guard(lock);
+        for (int i = 0; i < siteCount; i++)
+            if (siteKinds[i] == kind && siteNames[i] == name) return i;
+        if (siteCount == MAX_SITES) return -1;
+        siteNames[siteCount] = name;
+        siteKinds[siteCount] = kind;
+        return siteCount++;
+    }
+
+    // ǰ̵߳ͳƣ״εʱ䲢Ǽ
+    ThreadData& thread() {
+        static thread_local ThreadData* mine = nullptr;
+        if (!mine) {
+            std::unique_ptr<ThreadData> t(new ThreadData());
+            if (perf && !openPerf(*t)) perfFailures.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> guard(lock);
+            t->tid = (int)threads.size();
+            mine = t.get();
+            threads.push_back(std::move(t));
+        }
+        return *mine;
+    }
+
+    uint64_t now() const {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void record(int s, uint64_t value) {
+        SiteStats& st = thread().sites[s];
+        st.count.add(1);
+        st.sum.add(value);
+        st.maxValue.raise(value);
+        st.hist[bucketOf(value)].add(1);
+    }
+
+    void report(std::ostream& out);
+    bool writeChromeTrace(const std::string& path);
+
+    ~Registry() {
+        if (enabled) report(std::cerr);
+        if (tracing && !writeChromeTrace(tracePath))
+            std::cerr << "[instrument] ޷д׷ļ " << tracePath << std::endl;
+    }
+
+private:
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex lock;
+    std::string siteNames[MAX_SITES];
+    SiteKind siteKinds[MAX_SITES];
+    int siteCount = 0;
+    std::vector<std::unique_ptr<ThreadData>> threads;
+    std::atomic<int> perfFailures{ 0 };
+
+    // ȡδʱؿմMSVC  /sdl  getenv  C4996 浱󣬸 _dupenv_s
+    static std::string readEnv(const char* name) {
+#ifdef _MSC_VER
+        char* buf = nullptr;
+        size_t len = 0;
+        std::string value;
+        if (_dupenv_s(&buf, &len, name) == 0 && buf) value = buf;
+        free(buf);
+        return value;
+#else
+        const char* v = getenv(name);
+        return v ? v : "";
+#endif
+    }
+
+    Registry() {
+        std::string e = readEnv("INSTRUMENT");
+        std::string p = readEnv("INSTRUMENT_PERF");
+        tracePath = readEnv("INSTRUMENT_TRACE");
+        tracing = !tracePath.empty();
+        enabled = tracing || (!e.empty() && e != "0");
+        perf = enabled && !p.empty() && p != "0";
+    }
+
+    // ߳ͬһ׮ͳ
+    struct Totals {
+        uint64_t count = 0, sum = 0, maxValue = 0;
+        uint64_t perf[PERF_EVENT_COUNT] = { 0, 0, 0 };
+        uint64_t hist[HIST_BUCKETS] = {};
+    };
+
+    Totals totals(int s) {
+        Totals r;
+        for (auto& t : threads) {
+            const SiteStats& st = t->sites[s];
+            r.count += st.count.get();
+            r.sum += st.sum.get();
+            if (st.maxValue.get() > r.maxValue) r.maxValue = st.maxValue.get();
+            for (int i = 0; i < PERF_EVENT_COUNT; i++) r.perf[i] += st.perf[i].get();
+            for (int b = 0; b < HIST_BUCKETS; b++) r.hist[b] += st.hist[b].get();
+        }
+        return r;
+    }
+
+    // ֱͼĵ p λȡͰϽ磨ֵ
+    static uint64_t percentile(const Totals& r, double p) {
+        uint64_t need = (uint64_t)(p * r.count + 0.5), seen = 0;
+        if (need == 0) need = 1;
+        for (int b = 0; b < HIST_BUCKETS; b++) {
+            seen += r.hist[b];
+            if (seen >= need) {
+                uint64_t high = b + 1 < HIST_BUCKETS ? bucketLow(b + 1) - 1 : r.maxValue;
+                return high < r.maxValue ? high : r.maxValue;
+            }
+        }
+        return r.maxValue;
+    }
+};
+
+// ׮˳ʱͳһܣڼʱ߳дͳƿֻһ
+inline void Registry::report(std::ostream& out) {
+    std::lock_guard<std::mutex> guard(lock);
+    out << "\n[instrument] ߳: " << threads.size();
+    if (perf) out << " | Ӳ: " << (perfFailures.load() ? "perf_event_open " : "ѿ");
+    out << "\n";
+    char line[512];
+    for (int s = 0; s < siteCount; s++) {
+        Totals r = totals(s);
+        if (r.count == 0) continue;
+        const char* name = siteNames[s].c_str();
+        if (siteKinds[s] == SITE_SCOPE) {
+            snprintf(line, sizeof(line),
+                " %-28s | : %llu | ܼ(ms): %.3f | ƽ(us): %.3f | p50(us): %.3f | p99(us): %.3f | (us): %.3f",
+                name, (unsigned long long)r.count, r.sum / 1e6, r.sum / 1e3 / r.count,
+                percentile(r, 0.5) / 1e3, percentile(r, 0.99) / 1e3, r.maxValue / 1e3);
+            out << line;
+            if (perf && !perfFailures.load()) {
+                snprintf(line, sizeof(line), " | /: %.0f | δ/: %.1f | ֧δ/: %.1f",
+                    (double)r.perf[PERF_CYCLES] / r.count, (double)r.perf[PERF_CACHE_MISSES] / r.count,
+                    (double)r.perf[PERF_BRANCH_MISSES] / r.count);
+                out << line;
+            }
+        }
+        else if (siteKinds[s] == SITE_COUNTER) {
+            snprintf(line, sizeof(line), " %-28s | ܼ: %llu | : %llu",
+                name, (unsigned long long)r.sum, (unsigned long long)r.count);
+            out << line;
+        }
+        else {
+            snprintf(line, sizeof(line), "ֱͼ %-28s | : %llu | ƽ: %.1f | p50: %llu | p99: %llu | : %llu",
+                name, (unsigned long long)r.count, (double)r.sum / r.count,
+                (unsigned long long)percentile(r, 0.5), (unsigned long long)percentile(r, 0.99),
+                (unsigned long long)r.maxValue);
+            out << line;
+        }
+        out << "\n";
+    }
+    uint64_t dropped = 0;
+    for (auto& t : threads) dropped += t->droppedEvents;
+    if (dropped) out << "[instrument] ׷ٻ¼: " << dropped << "\n";
+}
+
+// Chrome trace-event ʽÿһ "X"¼ʱ䵥λ΢
+inline bool Registry::writeChromeTrace(const std::string& path) {
+    std::lock_guard<std::mutex> guard(lock);
+    std::ofstream out(path.c_str(), std::ios::binary);
+    if (!out) return false;
+    auto writeName = [&](const std::string& s) {
+        out << '"';
+        for (unsigned char c : s) {
+            if (c == '"' || c == '\\') out << '\\' << c;
+            else if (c < 0x20) out << ' ';
+            else out << c;
+        }
+        out << '"';
+    };
+    char num[64];
+    bool first = true;
+    out << "{\"traceEvents\":[";
+    for (auto& t : threads) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t->tid
+            << ",\"args\":{\"name\":\"thread " << t->tid << "\"}}";
+        for (const TraceEvent& e : t->trace) {
+            out << ",\n{\"name\":";
+            writeName(siteNames[e.site]);
+            snprintf(num, sizeof(num), "%.3f,\"dur\":%.3f", e.start / 1e3, e.duration / 1e3);
+            out << ",\"cat\":\"instrument\",\"ph\":\"X\",\"pid\":1,\"tid\":" << t->tid << ",\"ts\":" << num << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return (bool)out;
+}
+
+// ʱرʱֻһжϣֻжһοָ
+class Scope {
+public:
+    explicit Scope(int s) {
+        Registry& r = Registry::get();
+        if (!r.enabled || s < 0) return;
+        site = s;
+        data = &r.thread();
+        if (r.perf) perfValid = readPerf(*data, perfStart);
+        start = r.now();
+    }
+
+    ~Scope() {
+        if (!data) return;
+        Registry& r = Registry::get();
+        uint64_t end = r.now();
+        r.record(site, end - start);
+        uint64_t perfEnd[PERF_EVENT_COUNT];
+        if (perfValid && readPerf(*data, perfEnd))
+            for (int i = 0; i < PERF_EVENT_COUNT; i++) data->sites[site].perf[i].add(perfEnd[i] - perfStart[i]);
+        if (r.tracing) {
+            if (data->trace.size() < MAX_TRACE_EVENTS) data->trace.push_back({ site, start, end - start });
+            else data->droppedEvents++;
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    ThreadData* data = nullptr;
+    int site = -1;
+    bool perfValid = false;
+    uint64_t start = 0;
+    uint64_t perfStart[PERF_EVENT_COUNT];
+};
+
+inline void add(int site, uint64_t delta) {
+    Registry& r = Registry::get();
+    if (!r.enabled || site < 0) return;
+    SiteStats& st = r.thread().sites[site];
+    st.count.add(1);
+    st.sum.add(delta);
+}
+
+inline void sample(int site, uint64_t value) {
+    Registry& r = Registry::get();
+    if (!r.enabled || site < 0) return;
+    r.record(site, value);
+}
+
+} // namespace instrument
+
+#define INSTR_CONCAT_(a, b) a##b
+#define INSTR_CONCAT(a, b) INSTR_CONCAT_(a, b)
+
+#ifdef INSTRUMENT_DISABLED
+#define INSTR_SCOPE(name) ((void)0)
+#define INSTR_COUNT(name, n) ((void)0)
+#define INSTR_HIST(name, v) ((void)0)
+#else
+#define INSTR_SCOPE(name) \
+    static const int INSTR_CONCAT(instrSite_, __LINE__) = \
+        ::instrument::Registry::get().site(name, ::instrument::SITE_SCOPE); \
+    ::instrument::Scope INSTR_CONCAT(instrScope_, __LINE__)(INSTR_CONCAT(instrSite_, __LINE__))
+#define INSTR_COUNT(name, n) do { \
+        static const int instrSite = ::instrument::Registry::get().site(name, ::instrument::SITE_COUNTER); \
+        ::instrument::add(instrSite, (uint64_t)(n)); \
+    } while (0)
+#define INSTR_HIST(name, v) do { \
+        static const int instrSite = ::instrument::Registry::get().site(name, ::instrument::SITE_HISTOGRAM); \
+        ::instrument::sample(instrSite, (uint64_t)(v)); \
+    } while (0)
+#endif
+
+#endif
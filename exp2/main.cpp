@@ -7,6 +7,19 @@
 #include <cstring>
 #include <fstream>
 #include <cctype>
+#include <sstream>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <cmath>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "../common/instrument.h"
 using namespace std;
 
 // λͼ Bitmap
@@ -63,6 +76,8 @@ public:
 
     int size() const { return _sz; }
 
+    int bytes() const { return N; } // ռֽ
+
     void set(int k) { // õkλΪ1
         // Ƴexpand(k)const
         if (k >= 8 * N) {
@@ -102,6 +117,564 @@ public:
     }
 };
 
+// 64λֵλλ±꣨MSVC  GCC/Clang ʹڽָ
+inline int popcount64(uint64_t x) {
+#ifdef _MSC_VER
+    return (int)__popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+inline int ctz64(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// ѹλͼRoaring ṹ32λ±갴16λֿ飬ÿ 65536 Ԫأѡ
+//   ĵ16λֵԪز 4096 ʱʹãÿԪ 2 ֽڣ
+//   λͼ1024  64 λ̶֣ 8KBԪؽ϶ʱʹã
+//   γ[, -1] У runOptimize() ν϶ࡢǰ߸ʡռʱת
+// 㰴Ź鲢ֻ߶еĿ飨ֱӸƵߵĿ飨
+class RoaringBitmap {
+public:
+    void set(uint32_t k) {
+        int i = findOrCreate(k >> 16);
+        Container& c = containers[i];
+        uint16_t low = (uint16_t)(k & 0xFFFF);
+        if (c.type == RUN) expandRun(c);
+        if (c.type == ARRAY) {
+            auto it = lower_bound(c.values.begin(), c.values.end(), low);
+            if (it != c.values.end() && *it == low) return;
+            c.values.insert(it, low);
+            c.card++;
+            if (c.card > ARRAY_LIMIT) toBitset(c);
+        } else {
+            uint64_t& w = c.words[low >> 6];
+            uint64_t bit = 1ULL << (low & 63);
+            if (!(w & bit)) {
+                w |= bit;
+                c.card++;
+            }
+        }
+    }
+
+    void clear(uint32_t k) {
+        int i = find(k >> 16);
+        if (i < 0) return;
+        Container& c = containers[i];
+        uint16_t low = (uint16_t)(k & 0xFFFF);
+        if (c.type == RUN) expandRun(c);
+        if (c.type == ARRAY) {
+            auto it = lower_bound(c.values.begin(), c.values.end(), low);
+            if (it == c.values.end() || *it != low) return;
+            c.values.erase(it);
+            c.card--;
+        } else {
+            uint64_t& w = c.words[low >> 6];
+            uint64_t bit = 1ULL << (low & 63);
+            if (!(w & bit)) return;
+            w &= ~bit;
+            c.card--;
+            if (c.card <= ARRAY_LIMIT) toArray(c);
+        }
+        if (c.card == 0) {
+            keys.erase(keys.begin() + i);
+            containers.erase(containers.begin() + i);
+        }
+    }
+
+    bool test(uint32_t k) const {
+        int i = find(k >> 16);
+        return i >= 0 && contains(containers[i], (uint16_t)(k & 0xFFFF));
+    }
+
+    uint64_t cardinality() const {
+        uint64_t n = 0;
+        for (const Container& c : containers) n += c.card;
+        return n;
+    }
+
+    bool empty() const { return containers.empty(); }
+
+    // ÿԪص f(uint32_t)
+    template <class F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < containers.size(); i++) {
+            const Container& c = containers[i];
+            uint32_t high = (uint32_t)keys[i] << 16;
+            if (c.type == ARRAY) {
+                for (uint16_t v : c.values) f(high | v);
+            } else if (c.type == BITSET) {
+                for (int w = 0; w < WORDS; w++)
+                    for (uint64_t bits = c.words[w]; bits; bits &= bits - 1)
+                        f(high | (uint32_t)(w * 64 + ctz64(bits)));
+            } else {
+                for (size_t r = 0; r < c.values.size(); r += 2)
+                    for (uint32_t v = c.values[r], e = v + c.values[r + 1]; v <= e; v++) f(high | v);
+            }
+        }
+    }
+
+    vector<uint32_t> toVector() const {
+        vector<uint32_t> out;
+        out.reserve((size_t)cardinality());
+        forEach([&](uint32_t v) { out.push_back(v); });
+        return out;
+    }
+
+    // ÿ黻ռСһ
+    void runOptimize() {
+        for (Container& c : containers) {
+            if (c.type == RUN) expandRun(c);
+            int runs = countRuns(c);
+            if (runs * 4 < min(c.card * 2, WORDS * 8)) toRun(c);
+        }
+    }
+
+    // ǰռõĶڴֽ
+    size_t memoryBytes() const {
+        size_t bytes = sizeof(*this) + keys.capacity() * sizeof(uint16_t) + containers.capacity() * sizeof(Container);
+        for (const Container& c : containers)
+            bytes += c.values.capacity() * sizeof(uint16_t) + c.words.capacity() * sizeof(uint64_t);
+        return bytes;
+    }
+
+    // ĸ顢λͼγ
+    void containerCounts(int& arrays, int& bitsets, int& runs) const {
+        arrays = bitsets = runs = 0;
+        for (const Container& c : containers)
+            (c.type == ARRAY ? arrays : c.type == BITSET ? bitsets : runs)++;
+    }
+
+    static RoaringBitmap unite(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap out;
+        size_t i = 0, j = 0;
+        while (i < a.keys.size() || j < b.keys.size()) {
+            if (j == b.keys.size() || (i < a.keys.size() && a.keys[i] < b.keys[j])) {
+                out.push(a.keys[i], a.containers[i]);
+                i++;
+            } else if (i == a.keys.size() || b.keys[j] < a.keys[i]) {
+                out.push(b.keys[j], b.containers[j]);
+                j++;
+            } else {
+                out.push(a.keys[i], orContainers(a.containers[i], b.containers[j]));
+                i++, j++;
+            }
+        }
+        return out;
+    }
+
+    static RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap out;
+        for (size_t i = 0, j = 0; i < a.keys.size() && j < b.keys.size();) {
+            if (a.keys[i] < b.keys[j]) i++;
+            else if (b.keys[j] < a.keys[i]) j++;
+            else {
+                Container c = andContainers(a.containers[i], b.containers[j]);
+                if (c.card > 0) out.push(a.keys[i], move(c));
+                i++, j++;
+            }
+        }
+        return out;
+    }
+
+    // a ȥ b Ԫ
+    static RoaringBitmap subtract(const RoaringBitmap& a, const RoaringBitmap& b) {
+        RoaringBitmap out;
+        size_t j = 0;
+        for (size_t i = 0; i < a.keys.size(); i++) {
+            while (j < b.keys.size() && b.keys[j] < a.keys[i]) j++;
+            if (j == b.keys.size() || b.keys[j] != a.keys[i]) {
+                out.push(a.keys[i], a.containers[i]);
+                continue;
+            }
+            Container c = andNotContainers(a.containers[i], b.containers[j]);
+            if (c.card > 0) out.push(a.keys[i], move(c));
+        }
+        return out;
+    }
+
+    // лʽСˣ"RBM1" |  u32 | ÿ飺 u16 u8 u32/λͼΪԪγΪ
+    string serialize() const {
+        string out = "RBM1";
+        put(out, (uint32_t)keys.size(), 4);
+        for (size_t i = 0; i < keys.size(); i++) {
+            const Container& c = containers[i];
+            put(out, keys[i], 2);
+            put(out, c.type, 1);
+            if (c.type == BITSET) {
+                put(out, (uint32_t)c.card, 4);
+                for (uint64_t w : c.words) put(out, w, 8);
+            } else {
+                put(out, (uint32_t)(c.type == RUN ? c.values.size() / 2 : c.values.size()), 4);
+                for (uint16_t v : c.values) put(out, v, 2);
+            }
+        }
+        return out;
+    }
+
+    //  serialize() ʽϷʱ false Ҳ޸ out
+    static bool deserialize(const string& data, RoaringBitmap& out) {
+        size_t pos = 4;
+        if (data.compare(0, 4, "RBM1") != 0) return false;
+        RoaringBitmap bm;
+        uint64_t count;
+        if (!get(data, pos, 4, count) || count > 65536) return false;
+        for (uint64_t n = 0; n < count; n++) {
+            uint64_t key, type, len;
+            if (!get(data, pos, 2, key) || !get(data, pos, 1, type) || !get(data, pos, 4, len)) return false;
+            if (!bm.keys.empty() && key <= bm.keys.back()) return false;
+            Container c;
+            c.type = (ContainerType)type;
+            if (type == BITSET) {
+                c.words.resize(WORDS);
+                int card = 0;
+                for (uint64_t& w : c.words) {
+                    if (!get(data, pos, 8, w)) return false;
+                    card += popcount64(w);
+                }
+                if (card != (int)len || card <= ARRAY_LIMIT) return false;
+                c.card = card;
+            } else if (type == ARRAY || type == RUN) {
+                size_t values = type == RUN ? (size_t)len * 2 : (size_t)len;
+                if (len == 0 || len > 65536 || values > (data.size() - pos) / 2) return false;
+                c.values.resize(values);
+                for (uint16_t& v : c.values) {
+                    uint64_t x = 0;
+                    get(data, pos, 2, x);
+                    v = (uint16_t)x;
+                }
+                if (!validValues(c)) return false;
+            } else {
+                return false;
+            }
+            bm.push((uint16_t)key, move(c));
+        }
+        if (pos != data.size()) return false;
+        out = move(bm);
+        return true;
+    }
+
+private:
+    enum ContainerType : unsigned char { ARRAY, BITSET, RUN };
+    static const int ARRAY_LIMIT = 4096;  // Ԫλͼʡռ
+    static const int WORDS = 1024;        // λͼ 64 λ
+
+    struct Container {
+        ContainerType type = ARRAY;
+        int card = 0;
+        vector<uint16_t> values;  // ARRAYֵRUN볤-1 
+        vector<uint64_t> words;   // BITSET
+    };
+
+    vector<uint16_t> keys;       // 
+    vector<Container> containers;
+
+    // һС x λãѭΪͣѯʱûз֧Ԥʧ
+    static size_t lowerBound(const uint16_t* a, size_t n, uint16_t x) {
+        if (n == 0) return 0;
+        const uint16_t* base = a;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = base[half] < x ? base + half : base;
+            n -= half;
+        }
+        return (base - a) + (*base < x);
+    }
+
+    int find(uint32_t key) const {
+        size_t i = lowerBound(keys.data(), keys.size(), (uint16_t)key);
+        return i < keys.size() && keys[i] == key ? (int)i : -1;
+    }
+
+    int findOrCreate(uint32_t key) {
+        auto it = lower_bound(keys.begin(), keys.end(), (uint16_t)key);
+        int i = it - keys.begin();
+        if (it == keys.end() || *it != key) {
+            keys.insert(it, (uint16_t)key);
+            containers.insert(containers.begin() + i, Container());
+        }
+        return i;
+    }
+
+    void push(uint16_t key, Container c) {
+        keys.push_back(key);
+        containers.push_back(move(c));
+    }
+
+    static bool contains(const Container& c, uint16_t low) {
+        if (c.type == ARRAY) {
+            size_t i = lowerBound(c.values.data(), c.values.size(), low);
+            return i < c.values.size() && c.values[i] == low;
+        }
+        if (c.type == BITSET) return (c.words[low >> 6] >> (low & 63)) & 1;
+        // һ㲻 low γ
+        int lo = 0, hi = (int)c.values.size() / 2 - 1;
+        while (lo < hi) {
+            int mid = (lo + hi + 1) / 2;
+            if (c.values[2 * mid] <= low) lo = mid;
+            else hi = mid - 1;
+        }
+        return c.values[2 * lo] <= low && low <= c.values[2 * lo] + c.values[2 * lo + 1];
+    }
+
+    static void toBitset(Container& c) {
+        vector<uint64_t> words(WORDS, 0);
+        if (c.type == ARRAY) {
+            for (uint16_t v : c.values) words[v >> 6] |= 1ULL << (v & 63);
+        } else {
+            for (size_t r = 0; r < c.values.size(); r += 2) setRange(words, c.values[r], c.values[r] + c.values[r + 1]);
+        }
+        c.words.swap(words);
+        vector<uint16_t>().swap(c.values);
+        c.type = BITSET;
+    }
+
+    static void toArray(Container& c) {
+        vector<uint16_t> values;
+        values.reserve(c.card);
+        if (c.type == BITSET) {
+            for (int w = 0; w < WORDS; w++)
+                for (uint64_t bits = c.words[w]; bits; bits &= bits - 1) values.push_back((uint16_t)(w * 64 + ctz64(bits)));
+        } else {
+            for (size_t r = 0; r < c.values.size(); r += 2)
+                for (uint32_t v = c.values[r], e = v + c.values[r + 1]; v <= e; v++) values.push_back((uint16_t)v);
+        }
+        c.values.swap(values);
+        vector<uint64_t>().swap(c.words);
+        c.type = ARRAY;
+    }
+
+    static void expandRun(Container& c) {
+        if (c.card > ARRAY_LIMIT) toBitset(c);
+        else toArray(c);
+    }
+
+    static void setRange(vector<uint64_t>& words, uint32_t s, uint32_t e) {
+        for (uint32_t w = s >> 6; w <= e >> 6; w++) {
+            uint64_t mask = ~0ULL;
+            if (w == s >> 6) mask &= ~0ULL << (s & 63);
+            if (w == e >> 6) mask &= ~0ULL >> (63 - (e & 63));
+            words[w] |= mask;
+        }
+    }
+
+    // λͼе
+    static int countRuns(const Container& c) {
+        int runs = 0;
+        if (c.type == ARRAY) {
+            for (size_t i = 0; i < c.values.size(); i++)
+                if (i == 0 || c.values[i] != c.values[i - 1] + 1) runs++;
+        } else {
+            //  = λΪ1ǰһλΪ0
+            uint64_t prevTop = 0;
+            for (int w = 0; w < WORDS; w++) {
+                uint64_t x = c.words[w];
+                runs += popcount64(x & ~((x << 1) | prevTop));
+                prevTop = x >> 63;
+            }
+        }
+        return runs;
+    }
+
+    static void toRun(Container& c) {
+        vector<uint16_t> runs;
+        auto add = [&](uint32_t v) {
+            if (!runs.empty() && runs[runs.size() - 2] + runs.back() + 1 == (int)v) runs.back()++;
+            else runs.push_back((uint16_t)v), runs.push_back(0);
+        };
+        if (c.type == ARRAY) {
+            for (uint16_t v : c.values) add(v);
+        } else {
+            for (int w = 0; w < WORDS; w++)
+                for (uint64_t bits = c.words[w]; bits; bits &= bits - 1) add(w * 64 + ctz64(bits));
+        }
+        runs.shrink_to_fit();
+        c.values.swap(runs);
+        vector<uint64_t>().swap(c.words);
+        c.type = RUN;
+    }
+
+    // γ̼Ľʱγ̣Ԫתλͼ
+    static Container fromRuns(vector<uint16_t>& runs) {
+        Container c;
+        c.type = RUN;
+        c.values.swap(runs);
+        for (size_t r = 0; r < c.values.size(); r += 2) c.card += c.values[r + 1] + 1;
+        if (c.card > 0 && (int)c.values.size() * 2 >= min(c.card * 2, WORDS * 8)) expandRun(c);
+        return c;
+    }
+
+    static Container fromWords(vector<uint64_t>& words) {
+        Container c;
+        c.type = BITSET;
+        c.words.swap(words);
+        for (uint64_t w : c.words) c.card += popcount64(w);
+        if (c.card <= ARRAY_LIMIT) toArray(c);
+        return c;
+    }
+
+    static Container fromValues(vector<uint16_t>& values) {
+        Container c;
+        c.values.swap(values);
+        c.card = c.values.size();
+        if (c.card > ARRAY_LIMIT) toBitset(c);
+        return c;
+    }
+
+    static const Container& plain(const Container& c, Container& tmp) {
+        if (c.type != RUN) return c;
+        tmp = c;
+        expandRun(tmp);
+        return tmp;
+    }
+
+    static void appendRun(vector<uint16_t>& runs, uint32_t s, uint32_t e) {
+        if (!runs.empty() && runs[runs.size() - 2] + runs.back() + 1 >= (int)s) {
+            uint32_t end = max<uint32_t>(runs[runs.size() - 2] + runs.back(), e);
+            runs.back() = (uint16_t)(end - runs[runs.size() - 2]);
+        } else {
+            runs.push_back((uint16_t)s);
+            runs.push_back((uint16_t)(e - s));
+        }
+    }
+
+    static Container orContainers(const Container& x, const Container& y) {
+        if (x.type == RUN && y.type == RUN) {
+            vector<uint16_t> runs;
+            size_t i = 0, j = 0;
+            while (i < x.values.size() || j < y.values.size()) {
+                bool fromX = j == y.values.size() || (i < x.values.size() && x.values[i] < y.values[j]);
+                const vector<uint16_t>& src = fromX ? x.values : y.values;
+                size_t& k = fromX ? i : j;
+                appendRun(runs, src[k], src[k] + src[k + 1]);
+                k += 2;
+            }
+            return fromRuns(runs);
+        }
+        Container ta, tb;
+        const Container& a = plain(x, ta);
+        const Container& b = plain(y, tb);
+        if (a.type == ARRAY && b.type == ARRAY) {
+            vector<uint16_t> values(a.values.size() + b.values.size());
+            values.resize(set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), values.begin()) - values.begin());
+            return fromValues(values);
+        }
+        const Container& bits = a.type == BITSET ? a : b;
+        const Container& other = a.type == BITSET ? b : a;
+        vector<uint64_t> words = bits.words;
+        if (other.type == ARRAY) {
+            for (uint16_t v : other.values) words[v >> 6] |= 1ULL << (v & 63);
+        } else {
+            for (int w = 0; w < WORDS; w++) words[w] |= other.words[w];
+        }
+        return fromWords(words);
+    }
+
+    static Container andContainers(const Container& x, const Container& y) {
+        if (x.type == RUN && y.type == RUN) {
+            vector<uint16_t> runs;
+            for (size_t i = 0, j = 0; i < x.values.size() && j < y.values.size();) {
+                uint32_t xe = x.values[i] + x.values[i + 1], ye = y.values[j] + y.values[j + 1];
+                uint32_t s = max(x.values[i], y.values[j]), e = min(xe, ye);
+                if (s <= e) appendRun(runs, s, e);
+                if (xe < ye) i += 2;
+                else j += 2;
+            }
+            return fromRuns(runs);
+        }
+        Container ta, tb;
+        const Container& a = plain(x, ta);
+        const Container& b = plain(y, tb);
+        if (a.type == ARRAY && b.type == ARRAY) {
+            vector<uint16_t> values(min(a.values.size(), b.values.size()));
+            values.resize(set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), values.begin()) - values.begin());
+            return fromValues(values);
+        }
+        if (a.type == ARRAY || b.type == ARRAY) {
+            const Container& arr = a.type == ARRAY ? a : b;
+            const Container& bits = a.type == ARRAY ? b : a;
+            vector<uint16_t> values;
+            values.reserve(arr.values.size());
+            for (uint16_t v : arr.values)
+                if ((bits.words[v >> 6] >> (v & 63)) & 1) values.push_back(v);
+            return fromValues(values);
+        }
+        vector<uint64_t> words(WORDS);
+        for (int w = 0; w < WORDS; w++) words[w] = a.words[w] & b.words[w];
+        return fromWords(words);
+    }
+
+    static Container andNotContainers(const Container& x, const Container& y) {
+        if (x.type == RUN && y.type == RUN) {
+            vector<uint16_t> runs;
+            size_t j = 0;
+            for (size_t i = 0; i < x.values.size(); i += 2) {
+                uint32_t s = x.values[i], e = s + x.values[i + 1];
+                while (j < y.values.size() && (uint32_t)y.values[j] + y.values[j + 1] < s) j += 2;
+                for (size_t k = j; k < y.values.size() && y.values[k] <= e; k += 2) {
+                    if (y.values[k] > s) appendRun(runs, s, y.values[k] - 1);
+                    s = max<uint32_t>(s, (uint32_t)y.values[k] + y.values[k + 1] + 1);
+                }
+                if (s <= e) appendRun(runs, s, e);
+            }
+            return fromRuns(runs);
+        }
+        Container ta, tb;
+        const Container& a = plain(x, ta);
+        const Container& b = plain(y, tb);
+        if (a.type == ARRAY) {
+            vector<uint16_t> values;
+            values.reserve(a.values.size());
+            for (uint16_t v : a.values)
+                if (!contains(b, v)) values.push_back(v);
+            return fromValues(values);
+        }
+        vector<uint64_t> words = a.words;
+        if (b.type == ARRAY) {
+            for (uint16_t v : b.values) words[v >> 6] &= ~(1ULL << (v & 63));
+        } else {
+            for (int w = 0; w < WORDS; w++) words[w] &= ~b.words[w];
+        }
+        return fromWords(words);
+    }
+
+    static void put(string& out, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++) out.push_back((char)((v >> (8 * i)) & 0xFF));
+    }
+
+    static bool get(const string& data, size_t& pos, int bytes, uint64_t& v) {
+        if (data.size() - pos < (size_t)bytes) return false;
+        v = 0;
+        for (int i = 0; i < bytes; i++) v |= (uint64_t)(unsigned char)data[pos + i] << (8 * i);
+        pos += bytes;
+        return true;
+    }
+
+    // 鷴лõ/γǷ򡢲صԪԪ
+    static bool validValues(Container& c) {
+        c.card = 0;
+        if (c.type == ARRAY) {
+            for (size_t i = 1; i < c.values.size(); i++)
+                if (c.values[i] <= c.values[i - 1]) return false;
+            c.card = c.values.size();
+            return c.card <= ARRAY_LIMIT;
+        }
+        for (size_t r = 0; r < c.values.size(); r += 2) {
+            if ((uint32_t)c.values[r] + c.values[r + 1] > 0xFFFF) return false;
+            if (r > 0 && c.values[r] <= c.values[r - 2] + c.values[r - 1] + 1) return false;
+            c.card += c.values[r + 1] + 1;
+        }
+        return true;
+    }
+};
+
 // Huffman
 class HuffCode {
 private:
@@ -208,6 +781,7 @@ private:
 
 public:
     void build(const string& text) {
+        INSTR_SCOPE("HuffTree::build");
         // ͳַƵ
         map<char, int> freq;
         for (char c : text) {
@@ -217,9 +791,17 @@ public:
             }
         }
 
+        buildFromFreq(freq);
+    }
+
+    // Ƶʱظãᱻͷţ
+    void buildFromFreq(const map<char, int>& freq) {
+        clear(root);
+        root = nullptr;
+        codeTable.clear();
+
         // ıûĸֱӷ
         if (freq.empty()) {
-            root = nullptr;
             return;
         }
 
@@ -263,6 +845,8 @@ public:
     }
 
     string encode(const string& text) {
+        INSTR_SCOPE("HuffTree::encode");
+        INSTR_COUNT("HuffTree::encode.chars", text.size());
         string result;
         for (char c : text) {
             if (isalpha(c)) {
@@ -334,12 +918,685 @@ public:
     }
 };
 
+// ͳֽƵʣۼӵ freqHuffman  tANS õĵһ
+void countBytes(const unsigned char* data, int n, int freq[256]) {
+    for (int i = 0; i < n; i++) freq[data[i]]++;
+}
+
+// Huffman"01"ռÿֽڵ֣λǰ볤
+void collectHuffCodes(const BinNode* node, unsigned int bits, int len, unsigned int codeBits[256], int codeLen[256]) {
+    if (!node->left && !node->right) {
+        unsigned char s = (unsigned char)node->data;
+        codeBits[s] = bits;
+        codeLen[s] = len;
+        return;
+    }
+    collectHuffCodes(node->left, bits << 1, len + 1, codeBits, codeLen);
+    collectHuffCodes(node->right, (bits << 1) | 1, len + 1, codeBits, codeLen);
+}
+
+// ʽHuffmanֿؽ + ˥Ƶʣ
+// kʱֻʹǰk-1ۻƵʣ˰ͬ£贫
+// ֡ʽ2ֽڿ鳤Сˣ+ ֽڶıݣ鳤Ϊ0ʾ
+class StreamHuffCodec {
+private:
+    static const int BLOCK_SIZE = 4096;     // ÿֽ
+    static const int FREQ_LIMIT = 1 << 16;  // Ƶܺޣ루֤볤 < 32
+
+    int freq[256];
+    int total;
+    HuffTree tree;
+    unsigned int codeBits[256];
+    int codeLen[256];
+
+    // ǰƵؽHuffmanͱ
+    void rebuild() {
+        map<char, int> m;
+        for (int s = 0; s < 256; s++) m[(char)s] = freq[s];
+        tree.buildFromFreq(m);
+        collectHuffCodes(tree.getRoot(), 0, 0, codeBits, codeLen);
+    }
+
+    // һݸƵʣܺͳʱ˥
+    void update(const unsigned char* data, int n) {
+        countBytes(data, n, freq);
+        total += n;
+        while (total > FREQ_LIMIT) {
+            total = 0;
+            for (int s = 0; s < 256; s++) {
+                freq[s] = (freq[s] + 1) / 2;
+                total += freq[s];
+            }
+        }
+        rebuild();
+    }
+
+public:
+    StreamHuffCodec() {
+        reset();
+    }
+
+    // ָʼ״ֽ̬ƵΪ1˺ͽ˶Ӹ״̬ʼ
+    void reset() {
+        for (int s = 0; s < 256; s++) freq[s] = 1;
+        total = 256;
+        rebuild();
+    }
+
+    void encodeBlock(const unsigned char* data, int n, ostream& out) {
+        out.put((char)(n & 0xFF));
+        out.put((char)(n >> 8));
+
+        unsigned long long acc = 0;
+        int accBits = 0;
+        for (int i = 0; i < n; i++) {
+            acc = (acc << codeLen[data[i]]) | codeBits[data[i]];
+            accBits += codeLen[data[i]];
+            while (accBits >= 8) {
+                accBits -= 8;
+                out.put((char)((acc >> accBits) & 0xFF));
+            }
+        }
+        if (accBits > 0) {
+            out.put((char)((acc << (8 - accBits)) & 0xFF));
+        }
+        update(data, n);
+    }
+
+    void finish(ostream& out) {
+        out.put(0);
+        out.put(0);
+        out.flush();
+    }
+
+    // һ֡֡ʱfalse
+    bool decodeBlock(istream& in, ostream& out) {
+        int lo = in.get(), hi = in.get();
+        if (lo == EOF || hi == EOF) return false;
+        int n = lo | (hi << 8);
+        if (n == 0) return false;
+
+        vector<unsigned char> data(n);
+        int cur = 0, bitPos = 8;
+        for (int i = 0; i < n; i++) {
+            BinNode* node = tree.getRoot();
+            while (node->left || node->right) {
+                if (bitPos == 8) {
+                    cur = in.get();
+                    if (cur == EOF) return false;
+                    bitPos = 0;
+                }
+                bool bit = (cur >> (7 - bitPos)) & 1;
+                bitPos++;
+                node = bit ? node->right : node->left;
+            }
+            data[i] = (unsigned char)node->data;
+        }
+        out.write((const char*)data.data(), n);
+        out.flush();
+        update(data.data(), n);
+        return true;
+    }
+
+    // 룬лһ֤֡־ӳн
+    void encodeStream(istream& in, ostream& out) {
+        unsigned char buf[BLOCK_SIZE];
+        int n = 0;
+        int c;
+        while ((c = in.get()) != EOF) {
+            buf[n++] = (unsigned char)c;
+            if (n == BLOCK_SIZE || c == '\n') {
+                encodeBlock(buf, n, out);
+                out.flush();
+                n = 0;
+            }
+        }
+        if (n > 0) encodeBlock(buf, n, out);
+        finish(out);
+    }
+
+    void decodeStream(istream& in, ostream& out) {
+        while (decodeBlock(in, out)) {}
+    }
+};
+
+// tANSķǶԳϵ룬FSE 
+// Ƶȹһܺ TABLE_SIZE״̬ȡֵ [TABLE_SIZE, 2*TABLE_SIZE)ÿŵλһ״̬ɲõ
+// 롢ѭûݵķ֧4 ״̬洦ڷţصִС
+// ӺǰŲ˳дλĩβǰ 4 ״̬һڱλ
+class TansCodec {
+public:
+    static const int TABLE_LOG = 11;
+    static const int TABLE_SIZE = 1 << TABLE_LOG;
+    static const int STATES = 4;
+
+    // ƵŵܺΪ TABLE_SIZEֹķΪ1Ƶߵķ
+    static void normalize(const int freq[256], int norm[256]) {
+        long long total = 0;
+        for (int s = 0; s < 256; s++) total += freq[s];
+        int sum = 0, largest = -1;
+        for (int s = 0; s < 256; s++) {
+            norm[s] = freq[s] == 0 ? 0 : max(1, (int)((long long)freq[s] * TABLE_SIZE / total));
+            sum += norm[s];
+            if (freq[s] > 0 && (largest < 0 || norm[s] > norm[largest])) largest = s;
+        }
+        if (largest < 0) return;
+        norm[largest] += TABLE_SIZE - sum;
+        // ƵŲʱδŸ1ֻںܶŶ1ʱ֣
+        for (int s = 0; norm[largest] < 1; s = (s + 1) % 256)
+            if (s != largest && norm[s] > 1) norm[s]--, norm[largest]++;
+    }
+
+    // һƵʹλͷ
+    static double estimateBits(const int freq[256], const int norm[256]) {
+        double bits = STATES * TABLE_LOG;
+        for (int s = 0; s < 256; s++)
+            if (freq[s] > 0) bits += freq[s] * (TABLE_LOG - log2((double)norm[s]));
+        return bits;
+    }
+
+    void build(const int norm[256]) {
+        int cumul[257] = { 0 };
+        for (int s = 0; s < 256; s++) cumul[s + 1] = cumul[s] + norm[s];
+
+        // ÿŵ norm[s] λð̶ű
+        unsigned char spread[TABLE_SIZE];
+        const int step = (TABLE_SIZE >> 1) + (TABLE_SIZE >> 3) + 3;
+        for (int s = 0, pos = 0; s < 256; s++)
+            for (int i = 0; i < norm[s]; i++) {
+                spread[pos] = (unsigned char)s;
+                pos = (pos + step) & (TABLE_SIZE - 1);
+            }
+
+        int next[256];
+        memcpy(next, cumul, sizeof(next));
+        for (int u = 0; u < TABLE_SIZE; u++) stateTable[next[spread[u]]++] = (uint16_t)(TABLE_SIZE + u);
+        for (int s = 0; s < 256; s++) {
+            if (norm[s] == 0) continue;
+            // ״̬ x  s ʱ nb λʹ x >> nb  [norm, 2*norm)nb = (x + deltaNbBits) >> 16
+            int maxBits = TABLE_LOG - highBit(max(norm[s] - 1, 1));
+            if (norm[s] == 1) maxBits = TABLE_LOG;
+            transform[s].deltaNbBits = ((uint32_t)maxBits << 16) - ((uint32_t)norm[s] << maxBits);
+            transform[s].deltaFindState = cumul[s] - norm[s];
+        }
+
+        for (int s = 0; s < 256; s++) next[s] = norm[s];
+        for (int u = 0; u < TABLE_SIZE; u++) {
+            int s = spread[u], x = next[s]++;
+            int nb = TABLE_LOG - highBit(x);
+            decodeTable[u].symbol = (unsigned char)s;
+            decodeTable[u].nbBits = (unsigned char)nb;
+            decodeTable[u].newState = (uint16_t)((x << nb) - TABLE_SIZE);
+        }
+    }
+
+    // ׷ӵ out ĩβ
+    void encode(const unsigned char* data, int n, vector<unsigned char>& out) const {
+        size_t start = out.size();
+        out.resize(start + (size_t)n * TABLE_LOG / 8 + 16 + 8);
+        unsigned char* ptr = out.data() + start;
+        uint64_t acc = 0;
+        int bits = 0;
+        auto step = [&](uint32_t& x, unsigned char symbol) {
+            const SymbolTransform& t = transform[symbol];
+            uint32_t nb = (x + t.deltaNbBits) >> 16;
+            acc |= (uint64_t)(x & ((1u << nb) - 1)) << bits;
+            bits += nb;
+            x = stateTable[(x >> nb) + t.deltaFindState];
+        };
+        //  i ʹõ i % 4 ״̬ȴĩβղ4Ĳ֣ѭ4״̬ھֲ
+        uint32_t state[STATES] = { TABLE_SIZE, TABLE_SIZE, TABLE_SIZE, TABLE_SIZE };
+        int i = n - 1;
+        for (; i >= 0 && (i & 3) != 3; i--) {
+            step(state[i & 3], data[i]);
+            flush(ptr, acc, bits);
+        }
+        uint32_t s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3];
+        for (; i >= 3; i -= 4) {  // 4  4 * TABLE_LOG λϲ7λС64
+            step(s3, data[i]);
+            step(s2, data[i - 1]);
+            step(s1, data[i - 2]);
+            step(s0, data[i - 3]);
+            flush(ptr, acc, bits);
+        }
+        state[0] = s0, state[1] = s1, state[2] = s2, state[3] = s3;
+        for (int k = 0; k < STATES; k++) {
+            acc |= (uint64_t)(state[k] - TABLE_SIZE) << bits;
+            bits += TABLE_LOG;
+            flush(ptr, acc, bits);
+        }
+        acc |= 1ULL << bits;  // ڱλ˾ݴҵһλ
+        bits++;
+        flush(ptr, acc, bits);
+        out.resize(ptr - out.data() + (bits > 0));
+    }
+
+    //  n ţ𻵣λԲϣʱfalse
+    bool decode(const unsigned char* in, size_t size, unsigned char* out, int n) const {
+        if (size == 0 || in[size - 1] == 0) return false;
+        BackwardReader reader(in, size, (long long)(size - 1) * 8 + highBit(in[size - 1]));
+        uint32_t state[STATES];
+        for (int k = STATES - 1; k >= 0; k--) {
+            if (reader.pos < TABLE_LOG) return false;
+            state[k] = reader.read(TABLE_LOG);
+        }
+        auto step = [&](uint32_t& x, unsigned char& symbol) {
+            const DecodeEntry& e = decodeTable[x];
+            symbol = e.symbol;
+            if (reader.pos < e.nbBits) return false;
+            x = e.newState + reader.read(e.nbBits);
+            return true;
+        };
+        uint32_t s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3];
+        int i = 0;
+        for (; i + 4 <= n; i += 4)
+            if (!step(s0, out[i]) || !step(s1, out[i + 1]) || !step(s2, out[i + 2]) || !step(s3, out[i + 3])) return false;
+        state[0] = s0, state[1] = s1, state[2] = s2, state[3] = s3;
+        for (; i < n; i++)
+            if (!step(state[i & 3], out[i])) return false;
+        return reader.pos == 0;
+    }
+
+private:
+    struct SymbolTransform {
+        uint32_t deltaNbBits;
+        int deltaFindState;
+    };
+    struct DecodeEntry {
+        uint16_t newState;
+        unsigned char symbol;
+        unsigned char nbBits;
+    };
+
+    uint16_t stateTable[TABLE_SIZE];
+    SymbolTransform transform[256];
+    DecodeEntry decodeTable[TABLE_SIZE];
+
+    static int highBit(uint32_t x) {
+        int b = 0;
+        while (x >>= 1) b++;
+        return b;
+    }
+
+    // ֽдۼСˣʣ಻һֽڵλۼptr ֮Ҫ8ֽڿռ
+    static void flush(unsigned char*& ptr, uint64_t& acc, int& bits) {
+        for (int i = 0; i < 8; i++) ptr[i] = (unsigned char)(acc >> (8 * i));
+        ptr += bits >> 3;
+        acc >>= bits & ~7;
+        bits &= 7;
+    }
+
+    // ĩβǰλword ӵ base ֽ 8 ֽڣʱװ
+    struct BackwardReader {
+        const unsigned char* in;
+        size_t size;
+        long long pos;   // δȡλһζȡ [pos - nb, pos)
+        long long base = 0;
+        uint64_t word = 0;
+
+        BackwardReader(const unsigned char* in, size_t size, long long pos) : in(in), size(size), pos(pos) {
+            load(pos);
+        }
+
+        // û渲 top µ 57 λϣһֱͷ
+        void load(long long top) {
+            base = max(0LL, (top + 7) / 8 - 8);
+            word = 0;
+            for (size_t i = 0; i < 8 && base + i < size; i++) word |= (uint64_t)in[base + i] << (8 * i);
+        }
+
+        uint32_t read(int nb) {
+            long long top = pos;
+            pos -= nb;
+            if (pos < base * 8) load(top);
+            return (uint32_t)(word >> (pos - base * 8)) & ((1u << nb) - 1);
+        }
+    };
+};
+
+// ֿѹÿͳһֽƵʲһͬһƵʱ tANS Ҳ Huffman 
+// С HuffmantANSԭ洢ѡСһ֣Ҳǿֻһ֣ڱȽϣ
+// ѹ˱ʹѹͬĿС
+// ʽ u8 | ԭ u32 | [ַλͼ 32 ֽ + ÿַŵĹһƵ u16] | ݳ u32 | 
+class BlockCompressor {
+public:
+    enum Method { RAW, HUFFMAN, TANS, AUTO };
+
+    explicit BlockCompressor(Method mode = AUTO, int blockSize = 1 << 16) : mode(mode), blockSize(blockSize) {}
+
+    string compress(const string& input) {
+        string out;
+        for (int m = 0; m < 3; m++) blocksByMethod[m] = 0;
+        for (size_t off = 0; off < input.size(); off += blockSize) {
+            int n = (int)min<size_t>(blockSize, input.size() - off);
+            compressBlock((const unsigned char*)input.data() + off, n, out);
+        }
+        return out;
+    }
+
+    bool decompress(const string& input, string& output) {
+        output.clear();
+        size_t pos = 0;
+        vector<unsigned char> block;
+        while (pos < input.size()) {
+            uint64_t method, n, len;
+            if (!get(input, pos, 1, method) || !get(input, pos, 4, n) || method > TANS || n > (uint64_t)blockSize) return false;
+            int norm[256] = { 0 };
+            if (method != RAW && !readTable(input, pos, norm)) return false;
+            if (!get(input, pos, 4, len) || len > input.size() - pos) return false;
+            const unsigned char* data = (const unsigned char*)input.data() + pos;
+            pos += len;
+            block.resize(n);
+            if (method == RAW) {
+                if (len != n) return false;
+                memcpy(block.data(), data, len);
+            } else if (method == TANS) {
+                tans.build(norm);
+                if (!tans.decode(data, len, block.data(), (int)n)) return false;
+            } else if (!huffmanDecode(norm, data, len, block.data(), (int)n)) {
+                return false;
+            }
+            output.append((const char*)block.data(), block.size());
+        }
+        return true;
+    }
+
+    // һ compress иѡеĿ
+    int blocks(Method m) const { return blocksByMethod[m]; }
+
+private:
+    Method mode;
+    int blockSize;
+    int blocksByMethod[3] = { 0, 0, 0 };
+    TansCodec tans;
+    vector<unsigned char> payload;
+
+    void compressBlock(const unsigned char* data, int n, string& out) {
+        int freq[256] = { 0 }, norm[256];
+        countBytes(data, n, freq);
+        TansCodec::normalize(freq, norm);
+
+        HuffTree tree;
+        unsigned int codeBits[256];
+        int codeLen[256];
+        buildHuffman(norm, tree, codeBits, codeLen);
+        double huffBits = 0;
+        for (int s = 0; s < 256; s++) huffBits += (double)freq[s] * codeLen[s];
+        double tansBits = TansCodec::estimateBits(freq, norm);
+
+        Method method = mode;
+        if (mode == AUTO) {
+            double table = 8.0 * (32 + 2 * 256);
+            method = min(huffBits, tansBits) + table < 8.0 * n ? (tansBits < huffBits ? TANS : HUFFMAN) : RAW;
+        }
+
+        payload.clear();
+        if (method == TANS) {
+            tans.build(norm);
+            tans.encode(data, n, payload);
+        } else if (method == HUFFMAN) {
+            huffmanEncode(data, n, codeBits, codeLen);
+        } else {
+            payload.assign(data, data + n);
+        }
+        blocksByMethod[method]++;
+
+        put(out, method, 1);
+        put(out, n, 4);
+        if (method != RAW) writeTable(out, norm);
+        put(out, payload.size(), 4);
+        out.append((const char*)payload.data(), payload.size());
+    }
+
+    // ùһƵʽHuffman˰ͬһűؽͬһ
+    static void buildHuffman(const int norm[256], HuffTree& tree, unsigned int codeBits[256], int codeLen[256]) {
+        map<char, int> m;
+        for (int s = 0; s < 256; s++) {
+            codeLen[s] = 0;
+            if (norm[s] > 0) m[(char)s] = norm[s];
+        }
+        tree.buildFromFreq(m);
+        if (tree.getRoot()) collectHuffCodes(tree.getRoot(), 0, 0, codeBits, codeLen);
+    }
+
+    void huffmanEncode(const unsigned char* data, int n, const unsigned int codeBits[256], const int codeLen[256]) {
+        unsigned long long acc = 0;
+        int accBits = 0;
+        for (int i = 0; i < n; i++) {
+            acc = (acc << codeLen[data[i]]) | codeBits[data[i]];
+            accBits += codeLen[data[i]];
+            while (accBits >= 8) {
+                accBits -= 8;
+                payload.push_back((unsigned char)(acc >> accBits));
+            }
+        }
+        if (accBits > 0) payload.push_back((unsigned char)(acc << (8 - accBits)));
+    }
+
+    static bool huffmanDecode(const int norm[256], const unsigned char* in, size_t size, unsigned char* out, int n) {
+        HuffTree tree;
+        unsigned int codeBits[256];
+        int codeLen[256];
+        buildHuffman(norm, tree, codeBits, codeLen);
+        size_t bitPos = 0;
+        for (int i = 0; i < n; i++) {
+            const BinNode* node = tree.getRoot();
+            while (node->left || node->right) {
+                if (bitPos >= size * 8) return false;
+                bool bit = (in[bitPos >> 3] >> (7 - (bitPos & 7))) & 1;
+                bitPos++;
+                node = bit ? node->right : node->left;
+            }
+            out[i] = (unsigned char)node->data;
+        }
+        return true;
+    }
+
+    static void writeTable(string& out, const int norm[256]) {
+        for (int b = 0; b < 32; b++) {
+            int mask = 0;
+            for (int i = 0; i < 8; i++) mask |= (norm[b * 8 + i] > 0) << i;
+            out.push_back((char)mask);
+        }
+        for (int s = 0; s < 256; s++)
+            if (norm[s] > 0) put(out, norm[s], 2);
+    }
+
+    static bool readTable(const string& in, size_t& pos, int norm[256]) {
+        if (in.size() - pos < 32) return false;
+        size_t maskPos = pos;
+        pos += 32;
+        int sum = 0;
+        for (int s = 0; s < 256; s++) {
+            if (!((in[maskPos + s / 8] >> (s % 8)) & 1)) continue;
+            uint64_t v;
+            if (!get(in, pos, 2, v) || v == 0) return false;
+            norm[s] = (int)v;
+            sum += norm[s];
+        }
+        return sum == TansCodec::TABLE_SIZE;
+    }
+
+    static void put(string& out, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++) out.push_back((char)((v >> (8 * i)) & 0xFF));
+    }
+
+    static bool get(const string& data, size_t& pos, int bytes, uint64_t& v) {
+        if (data.size() - pos < (size_t)bytes) return false;
+        v = 0;
+        for (int i = 0; i < bytes; i++) v |= (uint64_t)(unsigned char)data[pos + i] << (8 * i);
+        pos += bytes;
+        return true;
+    }
+};
+
 // ȡݽı
 string readSpeechText() {
     return "I have a dream that one day this nation will rise up and live out the true meaning of its creed we hold these truths to be self evident that all men are created equal I have a dream that one day on the red hills of Georgia the sons of former slaves and the sons of former slave owners will be able to sit down together at the table of brotherhood I have a dream that one day even the state of Mississippi a state sweltering with the heat of injustice sweltering with the heat of oppression will be transformed into an oasis of freedom and justice I have a dream that my four little children will one day live in a nation where they will not be judged by the color of their skin but by the content of their character I have a dream today";
 }
 
-int main() {
+// ===================== ܲ =====================
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// ϡ輯ϣ [0, universe) оȡ count ±ꣻۼϣɶγ±
+vector<uint32_t> sparseIndices(mt19937& rng, uint32_t universe, int count) {
+    vector<uint32_t> v(count);
+    for (uint32_t& x : v) x = rng() % universe;
+    sort(v.begin(), v.end());
+    v.erase(unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+vector<uint32_t> clusteredIndices(mt19937& rng, uint32_t universe, int clusters, int maxLen) {
+    vector<uint32_t> v;
+    for (int c = 0; c < clusters; c++) {
+        uint32_t start = rng() % (universe - maxLen), len = 1 + rng() % maxLen;
+        for (uint32_t k = start; k < start + len; k++) v.push_back(k);
+    }
+    sort(v.begin(), v.end());
+    v.erase(unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+void benchBitmapCase(const char* name, const vector<uint32_t>& va, const vector<uint32_t>& vb, uint32_t universe, mt19937& rng) {
+    auto t0 = chrono::steady_clock::now();
+    Bitmap da, db;
+    for (uint32_t v : va) da.set((int)v);
+    for (uint32_t v : vb) db.set((int)v);
+    double denseBuild = elapsedMs(t0);
+
+    t0 = chrono::steady_clock::now();
+    RoaringBitmap ra, rb;
+    for (uint32_t v : va) ra.set(v);
+    for (uint32_t v : vb) rb.set(v);
+    ra.runOptimize();
+    rb.runOptimize();
+    double roaringBuild = elapsedMs(t0);
+
+    vector<uint32_t> probes(1000000);
+    for (uint32_t& p : probes) p = rng() % 2 ? va[rng() % va.size()] : rng() % universe;
+    long long denseHits = 0, roaringHits = 0;
+    t0 = chrono::steady_clock::now();
+    for (uint32_t p : probes) denseHits += da.test((int)p);
+    double denseTest = elapsedMs(t0);
+    t0 = chrono::steady_clock::now();
+    for (uint32_t p : probes) roaringHits += ra.test(p);
+    double roaringTest = elapsedMs(t0);
+
+    // λͼûм㣬ֻλɨֵ
+    long long denseUnion = 0, denseInter = 0;
+    t0 = chrono::steady_clock::now();
+    for (uint32_t k = 0; k < universe; k++) {
+        bool a = da.test((int)k), b = db.test((int)k);
+        denseUnion += a || b;
+        denseInter += a && b;
+    }
+    double denseOps = elapsedMs(t0);
+    t0 = chrono::steady_clock::now();
+    RoaringBitmap u = RoaringBitmap::unite(ra, rb), in = RoaringBitmap::intersect(ra, rb), d = RoaringBitmap::subtract(ra, rb);
+    double roaringOps = elapsedMs(t0);
+
+    uint64_t sum = 0, expected = 0;
+    t0 = chrono::steady_clock::now();
+    u.forEach([&](uint32_t v) { sum += v; });
+    double roaringIter = elapsedMs(t0);
+    for (uint32_t k = 0; k < universe; k++)
+        if (da.test((int)k) || db.test((int)k)) expected += k;
+
+    RoaringBitmap restored;
+    string bytes = ra.serialize();
+    bool same = denseHits == roaringHits && sum == expected && (uint64_t)denseUnion == u.cardinality() && (uint64_t)denseInter == in.cardinality() &&
+        d.cardinality() == ra.cardinality() - in.cardinality() && RoaringBitmap::deserialize(bytes, restored) &&
+        restored.toVector() == va;
+
+    int arrays, bitsets, runs;
+    ra.containerCounts(arrays, bitsets, runs);
+    cout << name << ": " << va.size() << " + " << vb.size() << " Ԫ, ֵ " << universe << endl;
+    cout << "  ڴ:  " << (da.bytes() + db.bytes()) / 1024 << " KB, ѹ " << (ra.memoryBytes() + rb.memoryBytes()) / 1024
+         << " KB (/λͼ/γ " << arrays << "/" << bitsets << "/" << runs << "), л " << bytes.size() / 1024 << " KB" << endl;
+    cout << "  :  " << denseBuild << " ms, ѹ " << roaringBuild << " ms; 10^6 βѯ:  " << denseTest
+         << " ms, ѹ " << roaringTest << " ms" << endl;
+    cout << "  /: λɨ " << denseOps << " ms, ѹ// " << roaringOps << " ms,  " << roaringIter
+         << " ms, У: " << (same ? "һ" : "һ") << endl;
+}
+
+// ƫбֲÿֵֽ 1/3 ĸʼ0 Լռ֮
+string skewedBytes(mt19937& rng, size_t n) {
+    string s(n, 0);
+    for (char& c : s) {
+        int g = 0;
+        while (g < 255 && rng() % 3 == 0) g++;
+        c = (char)g;
+    }
+    return s;
+}
+
+void benchEntropyCoders() {
+    mt19937 rng(777);
+    string speech;
+    while (speech.size() < (4u << 20)) speech += readSpeechText() + " ";
+    string random(1u << 20, 0);
+    for (char& c : random) c = (char)(rng() & 0xFF);
+    struct Input {
+        const char* name;
+        string data;
+    } inputs[] = { { "ݽı", speech }, { "ƫбֲ", skewedBytes(rng, 4u << 20) }, { "ֽ", random } };
+    const char* names[] = { "ԭ", "Huffman", "tANS", "Զѡ" };
+
+    for (const Input& in : inputs) {
+        cout << in.name << " (" << in.data.size() / 1024 << " KB):" << endl;
+        for (int m = BlockCompressor::HUFFMAN; m <= BlockCompressor::AUTO; m++) {
+            BlockCompressor codec((BlockCompressor::Method)m);
+            auto t0 = chrono::steady_clock::now();
+            string packed = codec.compress(in.data);
+            double encMs = elapsedMs(t0);
+            string restored;
+            t0 = chrono::steady_clock::now();
+            bool ok = codec.decompress(packed, restored) && restored == in.data;
+            double decMs = elapsedMs(t0);
+            double mb = in.data.size() / 1048576.0;
+            cout << "  " << names[m] << ": ѹ " << 100.0 * packed.size() / in.data.size() << "%,  "
+                 << mb / (encMs / 1000) << " MB/s,  " << mb / (decMs / 1000) << " MB/s";
+            if (m == BlockCompressor::AUTO)
+                cout << " ( Huffman/tANS/ԭ " << codec.blocks(BlockCompressor::HUFFMAN) << "/"
+                     << codec.blocks(BlockCompressor::TANS) << "/" << codec.blocks(BlockCompressor::RAW) << ")";
+            cout << ", У: " << (ok ? "һ" : "һ") << endl;
+        }
+    }
+}
+
+void benchBitmaps() {
+    const uint32_t universe = 1u << 28;
+    mt19937 rng(12345);
+    vector<uint32_t> a = sparseIndices(rng, universe, 100000), b = sparseIndices(rng, universe, 100000);
+    benchBitmapCase("ϡ輯", a, b, universe, rng);
+    a = clusteredIndices(rng, universe, 300, 10000);
+    b = clusteredIndices(rng, universe, 300, 10000);
+    benchBitmapCase("ۼ", a, b, universe, rng);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "bench") {
+        benchBitmaps();
+        benchEntropyCoders();
+        return 0;
+    }
+
+    // ʽģʽ-c ѹ׼룬-d ѹ׼룬д׼
+    if (argc > 1 && (string(argv[1]) == "-c" || string(argv[1]) == "-d")) {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        StreamHuffCodec codec;
+        if (string(argv[1]) == "-c") codec.encodeStream(cin, cout);
+        else codec.decodeStream(cin, cout);
+        return 0;
+    }
+
     cout << "=== Huffmanʵ ===" << endl;
     cout << "ı: ·½I have a dream" << endl;
 
@@ -387,5 +1644,14 @@ int main() {
         cout << "ѹ: " << compressionRatio << "%" << endl;
     }
 
+    // ʽԣٽ룬Ƿԭ
+    StreamHuffCodec encoder, decoder;
+    stringstream raw(text), packed, restored;
+    encoder.encodeStream(raw, packed);
+    decoder.decodeStream(packed, restored);
+    cout << "\n=== ʽ ===" << endl;
+    cout << "ԭʼ: " << text.length() << "ֽ, ѹ: " << packed.str().length() << "ֽ" << endl;
+    cout << "" << (restored.str() == text ? "һ" : "һ") << endl;
+
     return 0;
 }
\ No newline at end of file
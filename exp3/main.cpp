@@ -5,23 +5,339 @@
 #include <climits>
 #include <map>
 #include <set>
+#include <algorithm>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../common/instrument.h"
 using namespace std;
 
+/* ===================== ֻļӳ ===================== */
+
+/* ļӳΪֻڴ棬̿ɹͬһҳ */
+class MappedFile {
+private:
+    const char* ptr = nullptr;
+    size_t len = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { close(); return false; }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) { close(); return false; }
+        ptr = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!ptr) { close(); return false; }
+        len = (size_t)size.QuadPart;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        ptr = (const char*)p;
+        len = st.st_size;
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (ptr) UnmapViewOfFile(ptr);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (ptr) munmap((void*)ptr, len);
+#endif
+        ptr = nullptr;
+        len = 0;
+    }
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+};
+
+/* ===================== CSR ϡͼ ===================== */
+
+struct Edge {
+    int u, v, w;
+};
+
+/* ѹϡУCSR洢uĳΪ adj/weight[offset[u] .. offset[u+1])
+   Ϊ offset[n+1] + adj[m] + weight[m]
+   ݻ storage УbuildCSR ֱָӳͼļloadCSR أ */
+struct CSRGraph {
+    int n = 0;
+    const int* offset = nullptr;
+    const int* adj = nullptr;      // ߵյ
+    const int* weight = nullptr;   // Ȩ
+
+    vector<int> storage;
+    shared_ptr<MappedFile> file;
+
+    CSRGraph() = default;
+    CSRGraph(CSRGraph&&) = default;
+    CSRGraph& operator=(CSRGraph&&) = default;
+    CSRGraph(const CSRGraph& o) { *this = o; }
+    CSRGraph& operator=(const CSRGraph& o) {
+        n = o.n;
+        storage = o.storage;
+        file = o.file;
+        offset = o.offset; adj = o.adj; weight = o.weight;
+        if (!storage.empty()) bind(storage.data(), n, o.edgeCount());
+        return *this;
+    }
+
+    void bind(const int* base, int nodes, int m) {
+        n = nodes;
+        offset = base;
+        adj = base + n + 1;
+        weight = adj + m;
+    }
+
+    int edgeCount() const { return offset ? offset[n] : 0; }
+    int begin(int u) const { return offset[u]; }
+    int end(int u) const { return offset[u + 1]; }
+};
+
+/* ---------- ɱ߱CSRͼÿߴΣÿھӰ ---------- */
+CSRGraph buildCSR(int n, const vector<Edge>& edges, bool undirected = true) {
+    vector<int> cnt(n + 1, 0);
+    for (const Edge& e : edges) {
+        cnt[e.u + 1]++;
+        if (undirected) cnt[e.v + 1]++;
+    }
+    for (int i = 0; i < n; i++) cnt[i + 1] += cnt[i];
+    int m = cnt[n];
+
+    CSRGraph g;
+    g.storage.resize((size_t)n + 1 + 2 * (size_t)m);
+    int* offset = g.storage.data();
+    int* adj = offset + n + 1;
+    int* weight = adj + m;
+    copy(cnt.begin(), cnt.end(), offset);
+    g.bind(offset, n, m);
+
+    for (const Edge& e : edges) {
+        adj[cnt[e.u]] = e.v; weight[cnt[e.u]++] = e.w;
+        if (undirected) { adj[cnt[e.v]] = e.u; weight[cnt[e.v]++] = e.w; }
+    }
+
+    vector<pair<int, int>> tmp;
+    for (int u = 0; u < n; u++) {
+        tmp.clear();
+        for (int k = offset[u]; k < offset[u + 1]; k++) tmp.push_back({ adj[k], weight[k] });
+        sort(tmp.begin(), tmp.end());
+        for (int k = offset[u]; k < offset[u + 1]; k++) {
+            adj[k] = tmp[k - offset[u]].first;
+            weight[k] = tmp[k - offset[u]].second;
+        }
+    }
+    return g;
+}
+
+/* ---------- ͼͼ߱ ---------- */
+CSRGraph reverseCSR(const CSRGraph& g) {
+    vector<Edge> edges;
+    edges.reserve(g.edgeCount());
+    for (int u = 0; u < g.n; u++)
+        for (int k = g.begin(u); k < g.end(u); k++)
+            edges.push_back({ g.adj[k], u, g.weight[k] });
+    return buildCSR(g.n, edges, false);
+}
+
+/* ===================== ͼļн߱ı/ӳ CSR ===================== */
+
+/* ƸʽCSRFileHeader + offset[n+1] + adj[m] + weight[m]Ϊ 32 λ CSRGraph ڴ沼һ£
+    buildCSR ͬÿھӰ򣨵˫ͨȴöֲҷ򻡣 */
+struct CSRFileHeader {
+    char magic[4];   // "CSR1"
+    int n;
+    int m;
+    int reserved;
+};
+
+bool saveCSR(const CSRGraph& g, const string& path) {
+    ofstream out(path, ios::binary);
+    if (!out) return false;
+    int m = g.edgeCount();
+    CSRFileHeader h = { { 'C', 'S', 'R', '1' }, g.n, m, 0 };
+    out.write((const char*)&h, sizeof(h));
+    out.write((const char*)g.offset, sizeof(int) * (g.n + 1));
+    out.write((const char*)g.adj, sizeof(int) * m);
+    out.write((const char*)g.weight, sizeof(int) * m);
+    return (bool)out;
+}
+
+/* ---------- ӳͼļͼݲƣӳͬһļʱҳ ---------- */
+bool loadCSR(const string& path, CSRGraph& g) {
+    shared_ptr<MappedFile> file = make_shared<MappedFile>();
+    if (!file->open(path) || file->size() < sizeof(CSRFileHeader)) return false;
+    const CSRFileHeader* h = (const CSRFileHeader*)file->data();
+    if (memcmp(h->magic, "CSR1", 4) != 0 || h->n < 0 || h->m < 0) return false;
+    if (file->size() < sizeof(CSRFileHeader) + sizeof(int) * ((size_t)h->n + 1 + 2 * (size_t)h->m)) return false;
+
+    // һ O(n+m) УƫƵβǺϡյڷΧÿڽӱ
+    // 𻵵ļܾ֮Էİ±ʡڽӱ϶
+    const int* base = (const int*)(file->data() + sizeof(CSRFileHeader));
+    const int* adj = base + h->n + 1;
+    if (base[0] != 0 || base[h->n] != h->m) return false;
+    for (int u = 0; u < h->n; u++)
+        if (base[u] > base[u + 1]) return false;
+    for (int u = 0; u < h->n; u++)
+        for (int k = base[u]; k < base[u + 1]; k++) {
+            if (adj[k] < 0 || adj[k] >= h->n) return false;
+            if (k > base[u] && adj[k - 1] > adj[k]) return false;
+        }
+
+    g = CSRGraph();
+    g.file = file;
+    g.bind(base, h->n, h->m);
+    return true;
+}
+
+/* ---------- һα߱ıÿ "u v [w]"ȱʡȨֵΪ 1'#'  '%' ͷΪע͡
+   ·㷨ҪȨǸȨʱֹͣظףȫ nullptr ---------- */
+const char* parseEdgeChunk(const char* p, const char* end, vector<Edge>& out) {
+    auto skipSpace = [&]() { while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++; };
+    auto readInt = [&](int& x) {
+        skipSpace();
+        bool neg = false;
+        if (p < end && *p == '-') { neg = true; p++; }
+        if (p >= end || *p < '0' || *p > '9') return false;
+        x = 0;
+        while (p < end && *p >= '0' && *p <= '9') x = x * 10 + (*p++ - '0');
+        if (neg) x = -x;
+        return true;
+        };
+
+    while (p < end) {
+        skipSpace();
+        if (p < end && (*p == '#' || *p == '%' || *p == '\n')) {
+            while (p < end && *p != '\n') p++;
+            if (p < end) p++;
+            continue;
+        }
+        const char* line = p;
+        Edge e = { 0, 0, 1 };
+        if (readInt(e.u) && readInt(e.v)) {
+            readInt(e.w);
+            if (e.w < 0) return line;
+            if (e.u >= 0 && e.v >= 0) out.push_back(e);
+        }
+        while (p < end && *p != '\n') p++;
+        if (p < end) p++;
+    }
+    return nullptr;
+}
+
+/* ---------- н߱ļӳļб߽г threads ηֱn Ϊ󶥵 + 1
+   иȨʱһкźݲ false ---------- */
+bool parseEdgeListFile(const string& path, vector<Edge>& edges, int& n, int threads = 0) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    const char* base = file.data();
+    size_t len = file.size();
+
+    vector<size_t> cutPos(threads + 1);
+    cutPos[0] = 0;
+    cutPos[threads] = len;
+    for (int t = 1; t < threads; t++) {
+        size_t pos = max(cutPos[t - 1], max((size_t)1, len * t / threads));
+        while (pos < len && base[pos - 1] != '\n') pos++;
+        cutPos[t] = pos;
+    }
+
+    vector<vector<Edge>> parts(threads);
+    vector<const char*> bad(threads);
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.push_back(thread([&, t]() { bad[t] = parseEdgeChunk(base + cutPos[t], base + cutPos[t + 1], parts[t]); }));
+    bad[0] = parseEdgeChunk(base + cutPos[0], base + cutPos[1], parts[0]);
+    for (auto& th : pool) th.join();
+
+    for (const char* line : bad) {
+        if (!line) continue;
+        const char* eol = line;
+        while (eol < base + len && *eol != '\n' && *eol != '\r') eol++;
+        cout << path << "  " << count(base, line, '\n') + 1 << " бȨΪ: " << string(line, eol) << endl;
+        return false;
+    }
+
+    size_t total = 0;
+    for (auto& part : parts) total += part.size();
+    edges.clear();
+    edges.reserve(total);
+    n = 0;
+    for (auto& part : parts) {
+        for (const Edge& e : part) n = max(n, max(e.u, e.v) + 1);
+        edges.insert(edges.end(), part.begin(), part.end());
+        vector<Edge>().swap(part);
+    }
+    return true;
+}
+
+/* ---------- ߱ı ->  CSR ļ ---------- */
+bool convertEdgeList(const string& textPath, const string& binPath, bool undirected = true) {
+    vector<Edge> edges;
+    int n;
+    if (!parseEdgeListFile(textPath, edges, n)) return false;
+    return saveCSR(buildCSR(n, edges, undirected), binPath);
+}
+
 /* ===================== ͼ1Ȩͼ ===================== */
 
 const int INF = 1e9;
 vector<char> v1 = { 'A','B','C','D','E','F','G','H' };
 map<char, int> idx1;
 
-/* ---------- ͼ1ڽӾ ---------- */
-vector<vector<int>> buildGraph1() {
-    int n = v1.size();
-    vector<vector<int>> g(n, vector<int>(n, INF));
-    for (int i = 0; i < n; i++) g[i][i] = 0;
+/* ---------- ͼ1߱ ---------- */
+vector<Edge> graph1Edges() {
+    vector<Edge> edges;
 
     auto addEdge = [&](char a, char b, int w) {
-        int i = idx1[a], j = idx1[b];
-        g[i][j] = g[j][i] = w;
+        edges.push_back({ idx1[a], idx1[b], w });
         };
 
     addEdge('A', 'B', 4);
@@ -40,6 +356,18 @@ vector<vector<int>> buildGraph1() {
     addEdge('F', 'H', 3);
     addEdge('G', 'H', 14);
 
+    return edges;
+}
+
+/* ---------- ͼ1ڽӾ󣨽ڴӡ ---------- */
+vector<vector<int>> buildGraph1() {
+    int n = v1.size();
+    vector<vector<int>> g(n, vector<int>(n, INF));
+    for (int i = 0; i < n; i++) g[i][i] = 0;
+
+    for (const Edge& e : graph1Edges())
+        g[e.u][e.v] = g[e.v][e.u] = e.w;
+
     return g;
 }
 
@@ -60,8 +388,8 @@ void printMatrix(const vector<vector<int>>& g) {
 }
 
 /* ---------- BFS ---------- */
-void BFS(const vector<vector<int>>& g, int start) {
-    int n = g.size();
+void BFS(const CSRGraph& g, int start) {
+    int n = g.n;
     vector<bool> vis(n, false);
     queue<int> q;
 
@@ -72,8 +400,9 @@ void BFS(const vector<vector<int>>& g, int start) {
     while (!q.empty()) {
         int u = q.front(); q.pop();
         cout << v1[u] << " ";
-        for (int v = 0; v < n; v++) {
-            if (g[u][v] != INF && !vis[v]) {
+        for (int k = g.begin(u); k < g.end(u); k++) {
+            int v = g.adj[k];
+            if (!vis[v]) {
                 vis[v] = true;
                 q.push(v);
             }
@@ -83,55 +412,1109 @@ void BFS(const vector<vector<int>>& g, int start) {
 }
 
 /* ---------- DFS ---------- */
-void DFSUtil(const vector<vector<int>>& g, int u, vector<bool>& vis) {
+void DFSUtil(const CSRGraph& g, int u, vector<bool>& vis) {
     vis[u] = true;
     cout << v1[u] << " ";
-    for (int v = 0; v < g.size(); v++) {
-        if (g[u][v] != INF && !vis[v])
+    for (int k = g.begin(u); k < g.end(u); k++) {
+        int v = g.adj[k];
+        if (!vis[v])
             DFSUtil(g, v, vis);
     }
 }
 
-void DFS(const vector<vector<int>>& g, int start) {
-    vector<bool> vis(g.size(), false);
+void DFS(const CSRGraph& g, int start) {
+    vector<bool> vis(g.n, false);
     cout << "DFS: ";
     DFSUtil(g, start, vis);
     cout << endl;
 }
 
-/* ---------- Dijkstra ---------- */
-void Dijkstra(const vector<vector<int>>& g, int s) {
-    int n = g.size();
-    vector<int> dist(n, INF);
-    vector<bool> used(n, false);
+/* ===================== Ż BFS ===================== */
+
+/*  [0, n) ָ threads ִ߳ f(tid, begin, end)̳߳е 0  */
+template <class F>
+void parallelFor(int threads, int n, F f) {
+    if (threads <= 1 || n < 1024) { f(0, 0, n); return; }
+    vector<thread> pool;
+    int chunk = (n + threads - 1) / threads;
+    for (int t = 1; t < threads; t++) {
+        int b = min(n, t * chunk), e = min(n, b + chunk);
+        pool.push_back(thread(f, t, b, e));
+    }
+    f(0, 0, min(n, chunk));
+    for (auto& th : pool) th.join();
+}
+
+struct BFSResult {
+    vector<int> level;    // ɴΪ -1
+    vector<int> parent;   // BFS еĸڵ㣬ΪɴΪ -1
+    int topDownSteps = 0, bottomUpSteps = 0;
+};
+
+/* ---------- Beamer Ż BFS
+   Զʱ̷ֵ߳ǰ㣬ԭλͼռ¶㣻
+   ǰδʱ 1/alpha ʱΪԵϣδʶȥڵǰھӣ
+   ǰ㶥 n/beta лԶ¡
+   ԵҪҸڵ㣺in Ϊ߱ͼ &gͼ reverseCSR(g)
+   in Ϊʱ֪ߣֻԶ ---------- */
+BFSResult parallelBFS(const CSRGraph& g, int src, int threads = 0, const CSRGraph* in = nullptr, int alpha = 15, int beta = 18) {
+    int n = g.n;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    int words = (n + 63) / 64;
+
+    BFSResult r;
+    r.level.assign(n, -1);
+    r.parent.assign(n, -1);
+    vector<atomic<unsigned long long>> visited(words);
+    for (auto& w : visited) w.store(0, memory_order_relaxed);
+    vector<unsigned long long> front(words), next(words);
+
+    auto isSet = [](const vector<unsigned long long>& bm, int v) {
+        return (bm[v >> 6] >> (v & 63)) & 1;
+        };
+
+    vector<int> queue = { src };
+    visited[src >> 6].store(1ULL << (src & 63));
+    r.level[src] = 0;
+    r.parent[src] = src;
+
+    long long unexploredEdges = g.edgeCount() - (g.end(src) - g.begin(src));
+    bool bottomUp = false;
+    int depth = 0;
+    vector<vector<int>> localNext(threads);
+
+    while (!queue.empty()) {
+        long long frontierEdges = 0;
+        for (int u : queue) frontierEdges += g.end(u) - g.begin(u);
+
+        if (!in) bottomUp = false;
+        else if (!bottomUp && frontierEdges > unexploredEdges / alpha) bottomUp = true;
+        else if (bottomUp && queue.size() < (size_t)n / beta) bottomUp = false;
+
+        if (!bottomUp) {
+            r.topDownSteps++;
+            parallelFor(threads, queue.size(), [&](int tid, int b, int e) {
+                vector<int>& out = localNext[tid];
+                out.clear();
+                for (int i = b; i < e; i++) {
+                    int u = queue[i];
+                    for (int k = g.begin(u); k < g.end(u); k++) {
+                        int v = g.adj[k];
+                        unsigned long long bit = 1ULL << (v & 63);
+                        if (visited[v >> 6].load(memory_order_relaxed) & bit) continue;
+                        if (visited[v >> 6].fetch_or(bit) & bit) continue;   // ߳
+                        r.parent[v] = u;
+                        r.level[v] = depth + 1;
+                        out.push_back(v);
+                    }
+                }
+                });
+            queue.clear();
+            for (auto& out : localNext) queue.insert(queue.end(), out.begin(), out.end());
+        }
+        else {
+            r.bottomUpSteps++;
+            fill(front.begin(), front.end(), 0);
+            for (int u : queue) front[u >> 6] |= 1ULL << (u & 63);
+            //  64 λֶֻ㣬ÿֻһ߳дҪԭӲ
+            parallelFor(threads, words, [&](int tid, int b, int e) {
+                vector<int>& out = localNext[tid];
+                out.clear();
+                for (int w = b; w < e; w++) {
+                    unsigned long long vis = visited[w].load(memory_order_relaxed);
+                    unsigned long long found = 0;
+                    for (int bitIdx = 0; bitIdx < 64; bitIdx++) {
+                        int v = w * 64 + bitIdx;
+                        if (v >= n) break;
+                        if ((vis >> bitIdx) & 1) continue;
+                        for (int k = in->begin(v); k < in->end(v); k++) {
+                            if (isSet(front, in->adj[k])) {
+                                r.parent[v] = in->adj[k];
+                                r.level[v] = depth + 1;
+                                found |= 1ULL << bitIdx;
+                                out.push_back(v);
+                                break;
+                            }
+                        }
+                    }
+                    next[w] = found;
+                }
+                });
+            for (int w = 0; w < words; w++)
+                if (next[w]) visited[w].store(visited[w].load(memory_order_relaxed) | next[w], memory_order_relaxed);
+            queue.clear();
+            for (auto& out : localNext) queue.insert(queue.end(), out.begin(), out.end());
+        }
+
+        for (int v : queue) unexploredEdges -= g.end(v) - g.begin(v);
+        depth++;
+    }
+    return r;
+}
+
+/* ===================== Ż Dijkstra ===================== */
+
+/* 64λⳤ·֧ decrease-keyڵĶԪسʱ */
+typedef long long Dist;
+const Dist DIST_INF = LLONG_MAX / 4;
+
+/* ---------- 4 ---------- */
+class QuadHeap {
+private:
+    vector<pair<Dist, int>> a;
+
+public:
+    bool empty() const { return a.empty(); }
+    void clear() { a.clear(); }
+    const pair<Dist, int>& top() const { return a[0]; }
+
+    void push(Dist d, int v) {
+        int i = a.size();
+        a.push_back({ d, v });
+        while (i > 0) {
+            int p = (i - 1) / 4;
+            if (a[p].first <= a[i].first) break;
+            swap(a[p], a[i]);
+            i = p;
+        }
+    }
+
+    pair<Dist, int> pop() {
+        pair<Dist, int> top = a[0];
+        a[0] = a.back();
+        a.pop_back();
+        int n = a.size(), i = 0;
+        while (true) {
+            int c = 4 * i + 1;
+            if (c >= n) break;
+            int best = c;
+            int last = min(c + 4, n);
+            for (int j = c + 1; j < last; j++)
+                if (a[j].first < a[best].first) best = j;
+            if (a[i].first <= a[best].first) break;
+            swap(a[i], a[best]);
+            i = best;
+        }
+        return top;
+    }
+};
+
+/* ---------- ԶѣڵУ˺ϲ ---------- */
+class PairingHeap {
+private:
+    struct Node {
+        Dist key;
+        int v;
+        int child, sibling;
+    };
+    vector<Node> pool;
+    vector<int> buf;
+    int root = -1;
+
+    int meld(int a, int b) {
+        if (a < 0) return b;
+        if (b < 0) return a;
+        if (pool[b].key < pool[a].key) swap(a, b);
+        pool[b].sibling = pool[a].child;
+        pool[a].child = b;
+        return a;
+    }
+
+public:
+    bool empty() const { return root < 0; }
+    void clear() { pool.clear(); root = -1; }
+
+    void push(Dist d, int v) {
+        pool.push_back({ d, v, -1, -1 });
+        root = meld(root, pool.size() - 1);
+    }
+
+    pair<Dist, int> pop() {
+        pair<Dist, int> top = { pool[root].key, pool[root].v };
+        buf.clear();
+        for (int c = pool[root].child; c >= 0; ) {
+            int next = pool[c].sibling;
+            pool[c].sibling = -1;
+            buf.push_back(c);
+            c = next;
+        }
+        // һˣϲ
+        int m = buf.size(), k = 0;
+        for (int i = 0; i + 1 < m; i += 2) buf[k++] = meld(buf[i], buf[i + 1]);
+        if (m % 2) buf[k++] = buf[m - 1];
+        // ڶˣҵκϲ
+        int r = -1;
+        for (int i = k - 1; i >= 0; i--) r = meld(buf[i], r);
+        root = r;
+        return top;
+    }
+};
+
+/* ---------- ѣҪǸҵѣڷǸȨ ---------- */
+inline int bitLength(unsigned long long x) {
+    if (x == 0) return 0;
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return (int)idx + 1;
+#elif defined(__GNUC__)
+    return 64 - __builtin_clzll(x);
+#else
+    int len = 0;
+    while (x) { len++; x >>= 1; }
+    return len;
+#endif
+}
+
+class RadixHeap {
+private:
+    vector<pair<Dist, int>> bucket[65];
+    Dist last = 0;
+    size_t cnt = 0;
+
+public:
+    bool empty() const { return cnt == 0; }
+    void clear() {
+        for (auto& b : bucket) b.clear();
+        last = 0;
+        cnt = 0;
+    }
+
+    void push(Dist d, int v) {
+        bucket[bitLength((unsigned long long)(d ^ last))].push_back({ d, v });
+        cnt++;
+    }
+
+    pair<Dist, int> pop() {
+        if (bucket[0].empty()) {
+            int i = 1;
+            while (bucket[i].empty()) i++;
+            Dist mn = bucket[i][0].first;
+            for (auto& e : bucket[i]) mn = min(mn, e.first);
+            last = mn;
+            for (auto& e : bucket[i])
+                bucket[bitLength((unsigned long long)(e.first ^ last))].push_back(e);
+            bucket[i].clear();
+        }
+        pair<Dist, int> top = bucket[0].back();
+        bucket[0].pop_back();
+        cnt--;
+        return top;
+    }
+};
+
+enum HeapKind { HEAP_QUAD, HEAP_PAIRING, HEAP_RADIX };
+
+template <class Heap>
+void dijkstraWithHeap(const CSRGraph& g, int s, vector<Dist>& dist, vector<int>& pred, Heap& heap) {
+    dist.assign(g.n, DIST_INF);
+    pred.assign(g.n, -1);
+    heap.clear();
     dist[s] = 0;
+    heap.push(0, s);
 
-    for (int i = 0; i < n; i++) {
-        int u = -1, minD = INF;
-        for (int j = 0; j < n; j++)
-            if (!used[j] && dist[j] < minD)
-                minD = dist[j], u = j;
+    while (!heap.empty()) {
+        pair<Dist, int> top = heap.pop();
+        int u = top.second;
+        if (top.first != dist[u]) continue;   // Ԫ
 
-        if (u == -1) break;
-        used[u] = true;
+        for (int k = g.begin(u); k < g.end(u); k++) {
+            int v = g.adj[k];
+            Dist nd = top.first + g.weight[k];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pred[v] = u;
+                heap.push(nd, v);
+            }
+        }
+    }
+}
+
+/* ---------- Դ·dist Ϊ 64 λ루ɴΪ DIST_INFpred ΪǰͲɴΪ -1 ---------- */
+void shortestPaths(const CSRGraph& g, int s, vector<Dist>& dist, vector<int>& pred, HeapKind kind = HEAP_QUAD) {
+    INSTR_SCOPE("Dijkstra");
+    if (kind == HEAP_PAIRING) {
+        PairingHeap heap;
+        dijkstraWithHeap(g, s, dist, pred, heap);
+    }
+    else if (kind == HEAP_RADIX) {
+        RadixHeap heap;
+        dijkstraWithHeap(g, s, dist, pred, heap);
+    }
+    else {
+        QuadHeap heap;
+        dijkstraWithHeap(g, s, dist, pred, heap);
+    }
+}
+
+/* ---------- ǰ黹ԭ t ·ɴﷵؿգ ---------- */
+vector<int> extractPath(const vector<int>& pred, const vector<Dist>& dist, int t) {
+    vector<int> path;
+    if (dist[t] == DIST_INF) return path;
+    for (int v = t; v != -1; v = pred[v]) path.push_back(v);
+    reverse(path.begin(), path.end());
+    return path;
+}
+
+/* =====================  delta-stepping ===================== */
+
+/* ---------- ϣ󵽴̷߳ת̵߳ȴ仯 ---------- */
+class SpinBarrier {
+private:
+    int n;
+    atomic<int> count{ 0 };
+    atomic<int> generation{ 0 };
+
+public:
+    explicit SpinBarrier(int threads) : n(threads) {}
+
+    void wait() {
+        if (n == 1) return;
+        int gen = generation.load(memory_order_acquire);
+        if (count.fetch_add(1, memory_order_acq_rel) == n - 1) {
+            count.store(0, memory_order_relaxed);
+            generation.fetch_add(1, memory_order_release);
+        }
+        else {
+            while (generation.load(memory_order_acquire) == gen) this_thread::yield();
+        }
+    }
+};
+
+/* ---------- Ȩֲѡ deltaƽÿԼ LIGHT_PER_VERTEX ߣȨֵ delta
+   delta ԽÿͰظɳԽ࣬ԽСͰͬԽ ---------- */
+Dist tuneDelta(const CSRGraph& g) {
+    const double LIGHT_PER_VERTEX = 1.0;
+    int m = g.edgeCount();
+    if (m == 0) return 1;
+    vector<int> sample;
+    int stride = max(1, m / 100000);
+    for (int k = 0; k < m; k += stride) sample.push_back(g.weight[k]);
+    sort(sample.begin(), sample.end());
+    double avgDeg = (double)m / g.n;
+    double q = min(1.0, LIGHT_PER_VERTEX / avgDeg);
+    size_t idx = min(sample.size() - 1, (size_t)(q * sample.size()));
+    return max<Dist>(1, sample[idx]);
+}
+
+/* ---------- MeyerCSanders delta-stepping [b*delta, (b+1)*delta) Ķڵ b Ͱ
+   ͰŴСɳڵǰͰڶߣȨֵ <= deltaصǰͰĶٴһ֣
+   ֱǰͰ¶㣻ʱͰھȷٶЩɳһرߣֻ䵽Ͱ
+    64 λԭӱɳΪ CAS ʵֵԭȡС߳ڱذͰŴűµĶ㣬
+   ظܵǰʱִȥأʱѲڵǰͰĿֱִ߳ͬһѭϷָ׶Ρ
+    cur Ͱʱ¾ֻ cur .. cur + ceil(maxW/delta) ͰͰôĻ鰴Ͱȡģţ
+   Ȩ delta ʱⶥΪ DS_RING_CAPԶͰݴ map cur ƽٰػڡ
+   صľ Dijkstra ȫͬ̾Ψһɳ˳޹أdelta <= 0 ʱȨԶѡȡ ---------- */
+const long long DS_RING_CAP = 1 << 14;
+
+vector<Dist> deltaStepping(const CSRGraph& g, int s, int threads = 0, Dist delta = 0) {
+    int n = g.n;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    if (delta <= 0) delta = tuneDelta(g);
+    Dist maxW = 0;
+    for (int k = 0; k < g.edgeCount(); k++) maxW = max<Dist>(maxW, g.weight[k]);
+    const long long ring = min(DS_RING_CAP, (maxW + delta - 1) / delta + 1);
+
+    vector<atomic<Dist>> dist(n);
+    for (auto& d : dist) d.store(DIST_INF, memory_order_relaxed);
+    vector<atomic<unsigned char>> settled(n);
+    for (auto& f : settled) f.store(0, memory_order_relaxed);
+    vector<atomic<int>> queued(n);
+    for (auto& q : queued) q.store(0, memory_order_relaxed);
+    dist[s].store(0, memory_order_relaxed);
+
+    // ǰ齻ʹãһڴһռһֵĶ
+    vector<int> frontier[2] = { vector<int>(max(n, 1)), vector<int>(max(n, 1)) };
+    atomic<size_t> tail[2], head[2];
+    tail[0].store(1), tail[1].store(0), head[0].store(0), head[1].store(0);
+    frontier[0][0] = s;
+    atomic<long long> nextBin(LLONG_MAX);
+    SpinBarrier barrier(threads);
+    const long long NONE = LLONG_MAX;
+
+    auto worker = [&](int tid) {
+        vector<vector<int>> bins(ring);   // ̸߳¹Ķ㣬 b Ͱ bins[b % ring]
+        map<long long, vector<int>> far;  // Ͱ >= cur + ring Ķ
+        vector<int> removed;          // ߳ڵǰͰĶ
+        long long cur = 0;
+        int buf = 0, round = 0;   // ̵ִ߳μͬ
+
+        auto relax = [&](int v, Dist nd) {
+            Dist old = dist[v].load(memory_order_relaxed);
+            while (nd < old) {
+                if (dist[v].compare_exchange_weak(old, nd, memory_order_relaxed)) {
+                    long long b = nd / delta;
+                    if (b < cur + ring) bins[b % ring].push_back(v);
+                    else far[b].push_back(v);
+                    return;
+                }
+            }
+        };
+        // ѱص b Ͱ׷ӵǰ frontier[to]ִαȥأÿÿֻǰһΣ n 㹻
+        auto publish = [&](long long b, int to) {
+            vector<int>& local = bins[b % ring];
+            if (local.empty()) return;
+            size_t k = 0;
+            for (int v : local)
+                if (queued[v].exchange(round, memory_order_relaxed) != round) local[k++] = v;
+            size_t at = tail[to].fetch_add(k);
+            copy(local.begin(), local.begin() + k, frontier[to].begin() + at);
+            local.clear();
+        };
+
+        while (true) {
+            // ִ
+            while (true) {
+                const size_t CHUNK = 64;
+                size_t size = tail[buf].load(memory_order_acquire);
+                for (size_t i; (i = head[buf].fetch_add(CHUNK)) < size;) {
+                    for (size_t j = i; j < min(size, i + CHUNK); j++) {
+                        int u = frontier[buf][j];
+                        Dist du = dist[u].load(memory_order_relaxed);
+                        if (du / delta != cur) continue;
+                        removed.push_back(u);
+                        for (int k = g.begin(u); k < g.end(u); k++)
+                            if (g.weight[k] <= delta) relax(g.adj[k], du + g.weight[k]);
+                    }
+                }
+                barrier.wait();
+                int next = buf ^ 1;
+                if (tid == 0) head[buf].store(0), tail[buf].store(0);
+                round++;
+                publish(cur, next);
+                barrier.wait();
+                buf = next;
+                if (tail[buf].load(memory_order_acquire) == 0) break;
+            }
+
+            // ǰͰȶر߸ɳһ
+            for (int u : removed) {
+                if (settled[u].exchange(1, memory_order_relaxed)) continue;
+                Dist du = dist[u].load(memory_order_relaxed);
+                for (int k = g.begin(u); k < g.end(u); k++)
+                    if (g.weight[k] > delta) relax(g.adj[k], du + g.weight[k]);
+            }
+            removed.clear();
+
+            // ̱߳СķǿͰȡȫС
+            long long mine = NONE;
+            for (long long b = cur + 1; b < cur + ring; b++)
+                if (!bins[b % ring].empty()) { mine = b; break; }
+            if (mine == NONE && !far.empty()) mine = far.begin()->first;
+            long long seen = nextBin.load(memory_order_relaxed);
+            while (mine < seen && !nextBin.compare_exchange_weak(seen, mine, memory_order_relaxed)) {}
+            barrier.wait();
+            cur = nextBin.load(memory_order_relaxed);
+            if (cur == NONE) break;
+            while (!far.empty() && far.begin()->first < cur + ring) {
+                bins[far.begin()->first % ring].swap(far.begin()->second);
+                far.erase(far.begin());
+            }
+            round++;
+            publish(cur, buf);
+            barrier.wait();
+            if (tid == 0) nextBin.store(NONE, memory_order_relaxed);
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.push_back(thread(worker, t));
+    worker(0);
+    for (auto& th : pool) th.join();
+
+    vector<Dist> out(n);
+    for (int v = 0; v < n; v++) out[v] = dist[v].load(memory_order_relaxed);
+    return out;
+}
+
+/* ===================== ֿ FloydCWarshall ===================== */
+
+/* ---------- ͼţ߳뵽 FW_BLOCK ıĶΪ 0Ϊ INF
+   Ԫر <= INF 2*INF  int ΧڣԭֵȡСֻص <= INF
+    min(c, a + b) Ǳ㣬INF  ---------- */
+const int FW_BLOCK = 64;
+
+struct DistMatrix {
+    int n = 0;        // ʵʶ
+    int stride = 0;   // ı߳
+    vector<int> d;
+
+    explicit DistMatrix(int nodes = 0) : n(nodes), stride((nodes + FW_BLOCK - 1) / FW_BLOCK * FW_BLOCK) {
+        d.assign((size_t)stride * stride, INF);
+        for (int i = 0; i < stride; i++) d[(size_t)i * stride + i] = 0;
+    }
+
+    int* row(int i) { return d.data() + (size_t)i * stride; }
+    const int* row(int i) const { return d.data() + (size_t)i * stride; }
+    int at(int i, int j) const { return row(i)[j]; }
+
+    /* ڽӾ󹹽Ȩֵضϵ [0, INF] */
+    static DistMatrix fromAdjacency(const vector<vector<int>>& g) {
+        DistMatrix m(g.size());
+        for (int i = 0; i < m.n; i++)
+            for (int j = 0; j < m.n; j++)
+                m.row(i)[j] = i == j ? 0 : min(max(g[i][j], 0), INF);
+        return m;
+    }
+
+    vector<vector<int>> toVector() const {
+        vector<vector<int>> g(n, vector<int>(n));
+        for (int i = 0; i < n; i++) copy(row(i), row(i) + n, g[i].begin());
+        return g;
+    }
+};
+
+/* ----------  min-plusԿ k ִ C[i][j] = min(C[i][j], A[i][k] + B[k][j])
+   k 㣬A  B  C ͬһʱҲȷ k  C ĵ k С k вı䣨C[k][k] = 0
+   ڶԽǿԽǿͬͬеĿ ---------- */
+void fwBlockDependent(int* C, const int* A, const int* B, int stride) {
+    for (int k = 0; k < FW_BLOCK; k++) {
+        const int* bk = B + (size_t)k * stride;
+        for (int i = 0; i < FW_BLOCK; i++) {
+            int a = A[(size_t)i * stride + k];
+            int* c = C + (size_t)i * stride;
+#ifdef __AVX2__
+            __m256i va = _mm256_set1_epi32(a);
+            for (int j = 0; j < FW_BLOCK; j += 8) {
+                __m256i sum = _mm256_add_epi32(va, _mm256_loadu_si256((const __m256i*)(bk + j)));
+                _mm256_storeu_si256((__m256i*)(c + j), _mm256_min_epi32(_mm256_loadu_si256((const __m256i*)(c + j)), sum));
+            }
+#else
+            for (int j = 0; j < FW_BLOCK; j++) c[j] = min(c[j], a + bk[j]);
+#endif
+        }
+    }
+}
+
+/* ---------- 飺AB ڱѹ̶жC һУ64  intڼĴۼȫ k ---------- */
+void fwBlockIndependent(int* C, const int* A, const int* B, int stride) {
+    for (int i = 0; i < FW_BLOCK; i++) {
+        int* c = C + (size_t)i * stride;
+        const int* a = A + (size_t)i * stride;
+#ifdef __AVX2__
+        __m256i acc[FW_BLOCK / 8];
+        for (int v = 0; v < FW_BLOCK / 8; v++) acc[v] = _mm256_loadu_si256((const __m256i*)(c + v * 8));
+        for (int k = 0; k < FW_BLOCK; k++) {
+            __m256i va = _mm256_set1_epi32(a[k]);
+            const int* bk = B + (size_t)k * stride;
+            for (int v = 0; v < FW_BLOCK / 8; v++)
+                acc[v] = _mm256_min_epi32(acc[v], _mm256_add_epi32(va, _mm256_loadu_si256((const __m256i*)(bk + v * 8))));
+        }
+        for (int v = 0; v < FW_BLOCK / 8; v++) _mm256_storeu_si256((__m256i*)(c + v * 8), acc[v]);
+#else
+        int acc[FW_BLOCK];
+        copy(c, c + FW_BLOCK, acc);
+        for (int k = 0; k < FW_BLOCK; k++) {
+            const int* bk = B + (size_t)k * stride;
+            for (int j = 0; j < FW_BLOCK; j++) acc[j] = min(acc[j], a[k] + bk[j]);
+        }
+        copy(acc, acc + FW_BLOCK, c);
+#endif
+    }
+}
+
+/* ---------- ֿ FloydCWarshall kb Խǿ飬 kb С kb еĿ飨ֻԽǿ飩
+   飨ֻͬеĵ kb пͬеĵ kb п飩׶ڵĿ黥
+   ɸ߳ԭӼȡ׶֮ͬҪȨǸ ---------- */
+void floydWarshallBlocked(DistMatrix& m, int threads = 0) {
+    int nb = m.stride / FW_BLOCK, stride = m.stride;
+    if (nb == 0) return;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min(threads, max(1, (nb - 1) * (nb - 1)));
+    auto block = [&](int bi, int bj) { return m.d.data() + (size_t)bi * FW_BLOCK * stride + (size_t)bj * FW_BLOCK; };
+
+    SpinBarrier barrier(threads);
+    atomic<int> rowColNext(0), restNext(0);
+
+    auto worker = [&](int tid) {
+        for (int kb = 0; kb < nb; kb++) {
+            int* diag = block(kb, kb);
+            if (tid == 0) {
+                fwBlockDependent(diag, diag, diag, stride);
+                rowColNext.store(0);
+                restNext.store(0);
+            }
+            barrier.wait();
+
+            //  [0, nb) Ϊ kb еĿ飬[nb, 2nb) Ϊ kb еĿ
+            for (int t; (t = rowColNext.fetch_add(1)) < 2 * nb;) {
+                int j = t % nb;
+                if (j == kb) continue;
+                if (t < nb) fwBlockDependent(block(kb, j), diag, block(kb, j), stride);
+                else fwBlockDependent(block(j, kb), block(j, kb), diag, stride);
+            }
+            barrier.wait();
+
+            for (int t; (t = restNext.fetch_add(1)) < nb * nb;) {
+                int i = t / nb, j = t % nb;
+                if (i == kb || j == kb) continue;
+                fwBlockIndependent(block(i, j), block(i, kb), block(kb, j), stride);
+            }
+            barrier.wait();
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.push_back(thread(worker, t));
+    worker(0);
+    for (auto& th : pool) th.join();
+}
+
+/* ----------  FloydCWarshallգͬԪ <= INF ---------- */
+void floydWarshall(vector<vector<int>>& g) {
+    int n = g.size();
+    for (int k = 0; k < n; k++)
+        for (int i = 0; i < n; i++) {
+            int a = g[i][k];
+            if (a >= INF) continue;
+            for (int j = 0; j < n; j++) g[i][j] = min(g[i][j], a + g[k][j]);
+        }
+}
+
+/* ===================== Ե·ѯ ===================== */
+
+/* ---------- Ĺ epoch жϾǷڱβѯÿ· ---------- */
+struct SearchSpace {
+    vector<Dist> dist;
+    vector<unsigned> stamp;
+    unsigned epoch = 0;
+    QuadHeap heap;
+
+    void init(int n) {
+        dist.assign(n, DIST_INF);
+        stamp.assign(n, 0);
+        epoch = 0;
+    }
+
+    void nextQuery() {
+        heap.clear();
+        if (++epoch == 0) {   // ʱһ
+            fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    Dist get(int v) const { return stamp[v] == epoch ? dist[v] : DIST_INF; }
+    void set(int v, Dist d) { stamp[v] = epoch; dist[v] = d; }
+};
+
+/* ͼפڴ棬ÿ߳ж/query  tid ָʹĸ */
+class ShortestPathEngine {
+private:
+    const CSRGraph* fwd;
+    const CSRGraph* bwd;
+    CSRGraph rev;   // ͼʱ淴ͼ
+    vector<SearchSpace> fwdSpace, bwdSpace;
+    int threads;
+
+    // һĶչһ㣬ͬʱһľֵ
+    void step(const CSRGraph& g, SearchSpace& me, const SearchSpace& other, Dist& best) {
+        pair<Dist, int> top = me.heap.pop();
+        int u = top.second;
+        if (top.first != me.get(u)) return;
+        for (int k = g.begin(u); k < g.end(u); k++) {
+            int v = g.adj[k];
+            Dist nd = top.first + g.weight[k];
+            if (nd < me.get(v)) {
+                me.set(v, nd);
+                me.heap.push(nd, v);
+                Dist dv = other.get(v);
+                if (dv != DIST_INF && nd + dv < best) best = nd + dv;
+            }
+        }
+    }
+
+public:
+    ShortestPathEngine(const CSRGraph& g, bool undirected = true, int threadCount = 0) {
+        fwd = &g;
+        if (undirected) bwd = &g;
+        else {
+            rev = reverseCSR(g);
+            bwd = &rev;
+        }
+        threads = threadCount > 0 ? threadCount : max(1u, thread::hardware_concurrency());
+        fwdSpace.resize(threads);
+        bwdSpace.resize(threads);
+        for (int i = 0; i < threads; i++) {
+            fwdSpace[i].init(g.n);
+            bwdSpace[i].init(g.n);
+        }
+    }
+
+    int threadCount() const { return threads; }
+
+    /* ---------- ˫ DijkstraѶ֮ͲСڵǰֵʱǰɴﷵ DIST_INF ---------- */
+    Dist query(int s, int t, int tid = 0) {
+        if (s == t) return 0;
+        SearchSpace& F = fwdSpace[tid];
+        SearchSpace& B = bwdSpace[tid];
+        F.nextQuery();
+        B.nextQuery();
+        F.set(s, 0); F.heap.push(0, s);
+        B.set(t, 0); B.heap.push(0, t);
+
+        Dist best = DIST_INF;
+        while (!F.heap.empty() && !B.heap.empty()) {
+            Dist kf = F.heap.top().first, kb = B.heap.top().first;
+            if (kf + kb >= best) break;
+            if (kf <= kb) step(*fwd, F, B, best);
+            else step(*bwd, B, F, best);
+        }
+        return best;
+    }
+
+    /* ---------- һԶࣺ s Ŀ궼Ѻֹͣ ---------- */
+    void oneToMany(int s, const vector<int>& targets, vector<Dist>& out, int tid = 0) {
+        SearchSpace& F = fwdSpace[tid];
+        SearchSpace& B = bwdSpace[tid];   //  stamp Ŀ궥
+        F.nextQuery();
+        B.nextQuery();
+        int remaining = 0;
+        for (int x : targets)
+            if (B.get(x) == DIST_INF) { B.set(x, 0); remaining++; }
+
+        F.set(s, 0); F.heap.push(0, s);
+        while (!F.heap.empty() && remaining > 0) {
+            pair<Dist, int> top = F.heap.pop();
+            int u = top.second;
+            if (top.first != F.get(u)) continue;
+            if (B.get(u) == 0) { B.set(u, 1); remaining--; }
+            for (int k = fwd->begin(u); k < fwd->end(u); k++) {
+                int v = fwd->adj[k];
+                Dist nd = top.first + fwd->weight[k];
+                if (nd < F.get(v)) {
+                    F.set(v, nd);
+                    F.heap.push(nd, v);
+                }
+            }
+        }
+        out.resize(targets.size());
+        for (size_t i = 0; i < targets.size(); i++) out[i] = F.get(targets[i]);
+    }
+
+    /* ---------- Եѯ̶̬߳ȡһβѯ˳д ---------- */
+    void queryBatch(const vector<pair<int, int>>& queries, vector<Dist>& out) {
+        out.resize(queries.size());
+        atomic<size_t> next(0);
+        const size_t CHUNK = 16;
+        auto worker = [&](int tid) {
+            while (true) {
+                size_t b = next.fetch_add(CHUNK);
+                if (b >= queries.size()) break;
+                size_t e = min(b + CHUNK, queries.size());
+                for (size_t i = b; i < e; i++)
+                    out[i] = query(queries[i].first, queries[i].second, tid);
+            }
+            };
+        vector<thread> pool;
+        for (int i = 1; i < threads; i++) pool.push_back(thread(worker, i));
+        worker(0);
+        for (auto& th : pool) th.join();
+    }
+};
+
+/* ===================== ΣContraction Hierarchies ===================== */
+
+/* Ԥֻ""ıߣָߵĶ㣬ݾѯʱ˶ֻ
+   ļʽCHFileHeader + offset[n+1] + adj[m] + weight[m] + rank[n]Ϊ 32 λ
+   ֱӳ䵽ڴʹá֧ͼ */
+struct CHFileHeader {
+    char magic[4];   // "CH01"
+    int n;
+    int m;
+    int reserved;
+};
+
+class ContractionHierarchy {
+private:
+    struct Arc {
+        int to, w;
+    };
+
+    int n = 0, m = 0;
+    const int* offset = nullptr;
+    const int* adj = nullptr;
+    const int* weight = nullptr;
+    const int* rank = nullptr;
+    vector<int> offsetBuf, adjBuf, weightBuf, rankBuf;   // build Ľ
+    MappedFile file;                                     // load Ľ
+    SearchSpace fs, bs;
+
+    // ʣͼа u-v ߸Ϊ min(ԭȨ, w)û
+    static void addOrLower(vector<Arc>& list, int v, int w) {
+        for (Arc& a : list)
+            if (a.to == v) { a.w = min(a.w, w); return; }
+        list.push_back({ v, w });
+    }
 
+    // ֤Ĺtarget  epoch ǱҪȷĶ
+    struct WitnessSpace {
+        SearchSpace ws;
+        vector<unsigned> target;
+        unsigned epoch = 0;
+    };
+
+    // ֤ src  skip  Dijkstra
+    // ĿȫѡѶ limit  maxSettled ʱֹͣ
+    static void witnessSearch(const vector<vector<Arc>>& nb, WitnessSpace& w, int src, int skip, Dist limit, int targets, int maxSettled) {
+        SearchSpace& ws = w.ws;
+        ws.nextQuery();
+        ws.set(src, 0);
+        ws.heap.push(0, src);
+        int settled = 0;
+        while (!ws.heap.empty() && settled < maxSettled && targets > 0) {
+            pair<Dist, int> top = ws.heap.pop();
+            int u = top.second;
+            if (top.first != ws.get(u)) continue;
+            if (top.first > limit) break;
+            settled++;
+            if (w.target[u] == w.epoch) targets--;
+            for (const Arc& a : nb[u]) {
+                if (a.to == skip) continue;
+                Dist nd = top.first + a.w;
+                if (nd < ws.get(a.to)) {
+                    ws.set(a.to, nd);
+                    ws.heap.push(nd, a.to);
+                }
+            }
+        }
+    }
+
+    //  v ҪĽݾ (u, w, )ÿھ list[i]鵽 list[i+1..] Ƿڲ v ĸ·
+    // Ȩ 32 λţļʽһ£нݾȳ INT_MAX ʱ falseýݾĳȼΪ INT_MAX
+    static bool findShortcuts(const vector<vector<Arc>>& nb, WitnessSpace& w, int v, int maxSettled, vector<Edge>& out) {
+        out.clear();
+        bool fits = true;
+        const vector<Arc>& list = nb[v];
+        int d = list.size();
+        for (int i = 0; i + 1 < d; i++) {
+            if (++w.epoch == 0) {
+                fill(w.target.begin(), w.target.end(), 0);
+                w.epoch = 1;
+            }
+            int maxW = 0;
+            for (int j = i + 1; j < d; j++) {
+                maxW = max(maxW, list[j].w);
+                w.target[list[j].to] = w.epoch;
+            }
+            witnessSearch(nb, w, list[i].to, v, (Dist)list[i].w + maxW, d - 1 - i, maxSettled);
+            for (int j = i + 1; j < d; j++) {
+                Dist via = (Dist)list[i].w + list[j].w;
+                if (w.ws.get(list[j].to) > via) {
+                    if (via > INT_MAX) { fits = false; via = INT_MAX; }
+                    out.push_back({ list[i].to, list[j].to, (int)via });
+                }
+            }
+        }
+        return fits;
+    }
+
+    void useBuffers() {
+        offset = offsetBuf.data();
+        adj = adjBuf.data();
+        weight = weightBuf.data();
+        rank = rankBuf.data();
+    }
+
+    // صսṹbuild  load ʧʱãһεݻӳ
+    void reset() {
+        file.close();
+        n = m = 0;
+        offsetBuf.assign(1, 0);
+        adjBuf.clear(); weightBuf.clear(); rankBuf.clear();
+        useBuffers();
+        fs.init(0);
+        bs.init(0);
+    }
+
+public:
+    int size() const { return n; }
+    int arcCount() const { return m; }
+
+    /* ---------- Ԥ"߲ھ"µĴ㣬maxSettled Ϊ֤ĳޡ
+       ĳݾȳ 32 λȨʱ falseṹΪ ---------- */
+    bool build(const CSRGraph& g, int maxSettled = 100) {
+        file.close();
+        n = g.n;
+        vector<vector<Arc>> nb(n);
+        for (int u = 0; u < n; u++)
+            for (int k = g.begin(u); k < g.end(u); k++)
+                if (g.adj[k] != u) addOrLower(nb[u], g.adj[k], g.weight[k]);
+
+        vector<vector<Arc>> up(n);
+        vector<int> contractedNb(n, 0), level(n, 0);
+        rankBuf.assign(n, 0);
+        WitnessSpace ws;
+        ws.ws.init(n);
+        ws.target.assign(n, 0);
+        vector<Edge> shortcuts;
+
+        // ȼʱýСޣʱ maxSettled
+        const int estimateSettled = min(maxSettled, 20);
+        auto priority = [&](int v) {
+            findShortcuts(nb, ws, v, estimateSettled, shortcuts);
+            return 2 * ((int)shortcuts.size() - (int)nb[v].size()) + contractedNb[v] + level[v];
+            };
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+        for (int v = 0; v < n; v++) pq.push({ priority(v), v });
+
+        int order = 0;
+        while (!pq.empty()) {
+            int v = pq.top().second;
+            pq.pop();
+            int p = priority(v);
+            if (!pq.empty() && p > pq.top().first) {
+                pq.push({ p, v });
+                continue;
+            }
+
+            if (!findShortcuts(nb, ws, v, maxSettled, shortcuts)) {
+                reset();
+                return false;
+            }
+            rankBuf[v] = order++;
+            up[v] = nb[v];
+            for (const Arc& a : nb[v]) {
+                vector<Arc>& list = nb[a.to];
+                for (size_t k = 0; k < list.size(); k++)
+                    if (list[k].to == v) { list[k] = list.back(); list.pop_back(); break; }
+                contractedNb[a.to]++;
+                level[a.to] = max(level[a.to], level[v] + 1);
+            }
+            for (const Edge& e : shortcuts) {
+                addOrLower(nb[e.u], e.v, e.w);
+                addOrLower(nb[e.v], e.u, e.w);
+            }
+            nb[v].clear();
+            nb[v].shrink_to_fit();
+        }
+
+        offsetBuf.assign(n + 1, 0);
+        for (int v = 0; v < n; v++) offsetBuf[v + 1] = offsetBuf[v] + up[v].size();
+        m = offsetBuf[n];
+        adjBuf.resize(m);
+        weightBuf.resize(m);
         for (int v = 0; v < n; v++)
-            if (g[u][v] != INF && dist[v] > dist[u] + g[u][v])
-                dist[v] = dist[u] + g[u][v];
+            for (size_t k = 0; k < up[v].size(); k++) {
+                adjBuf[offsetBuf[v] + k] = up[v][k].to;
+                weightBuf[offsetBuf[v] + k] = up[v][k].w;
+            }
+        useBuffers();
+        fs.init(n);
+        bs.init(n);
+        return true;
+    }
+
+    bool save(const string& path) const {
+        ofstream out(path, ios::binary);
+        if (!out) return false;
+        CHFileHeader h = { { 'C', 'H', '0', '1' }, n, m, 0 };
+        out.write((const char*)&h, sizeof(h));
+        out.write((const char*)offset, sizeof(int) * (n + 1));
+        out.write((const char*)adj, sizeof(int) * m);
+        out.write((const char*)weight, sizeof(int) * m);
+        out.write((const char*)rank, sizeof(int) * n);
+        return (bool)out;
     }
 
+    /* ---------- ӳԤļݣҲԤ
+       һ O(n+m) Уƫơյ㡢Ȩ rankÿ߶ָ rank ߵĶ㣻κʧܶصսṹ ---------- */
+    bool load(const string& path) {
+        if (!file.open(path) || file.size() < sizeof(CHFileHeader)) { reset(); return false; }
+        const CHFileHeader* h = (const CHFileHeader*)file.data();
+        if (memcmp(h->magic, "CH01", 4) != 0 || h->n < 0 || h->m < 0) { reset(); return false; }
+        size_t need = sizeof(CHFileHeader) + sizeof(int) * ((size_t)2 * h->n + 1 + (size_t)2 * h->m);
+        if (file.size() < need) { reset(); return false; }
+
+        int fn = h->n, fm = h->m;
+        const int* fOffset = (const int*)(file.data() + sizeof(CHFileHeader));
+        const int* fAdj = fOffset + fn + 1;
+        const int* fWeight = fAdj + fm;
+        const int* fRank = fWeight + fm;
+        bool ok = fOffset[0] == 0 && fOffset[fn] == fm;
+        for (int v = 0; v < fn && ok; v++)
+            ok = fOffset[v] <= fOffset[v + 1] && fRank[v] >= 0 && fRank[v] < fn;
+        for (int v = 0; v < fn && ok; v++)
+            for (int k = fOffset[v]; k < fOffset[v + 1] && ok; k++)
+                ok = fAdj[k] >= 0 && fAdj[k] < fn && fWeight[k] >= 0 && fRank[fAdj[k]] > fRank[v];
+        if (!ok) { reset(); return false; }
+
+        n = fn;
+        m = fm;
+        offset = fOffset;
+        adj = fAdj;
+        weight = fWeight;
+        rank = fRank;
+        offsetBuf.clear(); adjBuf.clear(); weightBuf.clear(); rankBuf.clear();
+        fs.init(n);
+        bs.init(n);
+        return true;
+    }
+
+    /* ---------- ѯֻϵıĳһѶСڵǰֵʱòֹͣ ---------- */
+    Dist query(int s, int t) {
+        fs.nextQuery();
+        bs.nextQuery();
+        fs.set(s, 0); fs.heap.push(0, s);
+        bs.set(t, 0); bs.heap.push(0, t);
+        Dist best = DIST_INF;
+
+        while (true) {
+            bool fOpen = !fs.heap.empty() && fs.heap.top().first < best;
+            bool bOpen = !bs.heap.empty() && bs.heap.top().first < best;
+            if (!fOpen && !bOpen) break;
+            bool forward = fOpen && (!bOpen || fs.heap.top().first <= bs.heap.top().first);
+            SearchSpace& me = forward ? fs : bs;
+            const SearchSpace& other = forward ? bs : fs;
+
+            pair<Dist, int> top = me.heap.pop();
+            int u = top.second;
+            if (top.first != me.get(u)) continue;
+            Dist du = other.get(u);
+            if (du != DIST_INF && top.first + du < best) best = top.first + du;
+
+            // ͣ٣ܾɸ߲ھԸ̾뵽 uu ·ϣչ
+            bool stalled = false;
+            for (int k = offset[u]; k < offset[u + 1] && !stalled; k++) {
+                Dist dw = me.get(adj[k]);
+                if (dw != DIST_INF && dw + weight[k] < top.first) stalled = true;
+            }
+            if (stalled) continue;
+
+            for (int k = offset[u]; k < offset[u + 1]; k++) {
+                Dist nd = top.first + weight[k];
+                if (nd < me.get(adj[k])) {
+                    me.set(adj[k], nd);
+                    me.heap.push(nd, adj[k]);
+                }
+            }
+        }
+        return best;
+    }
+};
+
+/* ---------- Dijkstra ---------- */
+void Dijkstra(const CSRGraph& g, int s) {
+    int n = g.n;
+    vector<Dist> dist;
+    vector<int> pred;
+    shortestPaths(g, s, dist, pred);
+
     cout << "A ·\n";
-    for (int i = 0; i < n; i++)
-        cout << "A -> " << v1[i] << " = " << dist[i] << endl;
+    for (int i = 0; i < n; i++) {
+        cout << "A -> " << v1[i] << " = " << dist[i] << "  ·: ";
+        for (int v : extractPath(pred, dist, i)) cout << v1[v] << " ";
+        cout << endl;
+    }
 }
 
-/* ---------- Prim ---------- */
-void Prim(const vector<vector<int>>& g) {
-    int n = g.size();
+/* ---------- PrimO(n^2) ѡ㣩СɭȨֵͨʱһδʶ¿ʼ ---------- */
+long long primWeight(const CSRGraph& g) {
+    int n = g.n;
     vector<int> low(n, INF);
     vector<bool> used(n, false);
-    low[0] = 0;
-    int sum = 0;
+    long long sum = 0;
 
     for (int i = 0; i < n; i++) {
         int u = -1, minW = INF;
@@ -139,79 +1522,967 @@ void Prim(const vector<vector<int>>& g) {
             if (!used[j] && low[j] < minW)
                 minW = low[j], u = j;
 
+        if (u == -1) {   // ʣµĶѡֲͨʼµһ
+            for (int j = 0; j < n; j++)
+                if (!used[j]) { u = j; break; }
+            minW = 0;
+        }
         used[u] = true;
         sum += minW;
 
-        for (int v = 0; v < n; v++)
-            if (!used[v] && g[u][v] < low[v])
-                low[v] = g[u][v];
+        for (int k = g.begin(u); k < g.end(u); k++) {
+            int v = g.adj[k];
+            if (!used[v] && g.weight[k] < low[v])
+                low[v] = g.weight[k];
+        }
     }
+    return sum;
+}
 
-    cout << "СȨֵ: " << sum << endl;
+void Prim(const CSRGraph& g) {
+    cout << "СȨֵ: " << primWeight(g) << endl;
 }
 
+/* ===================== Kruskal / Boruvka Сɭ ===================== */
+
+/* ---------- 鼯· + Ⱥϲ ---------- */
+class UnionFind {
+private:
+    vector<int> parent;
+    vector<unsigned char> rnk;
+
+public:
+    UnionFind(int n) : parent(n), rnk(n, 0) {
+        for (int i = 0; i < n; i++) parent[i] = i;
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rnk[a] < rnk[b]) swap(a, b);
+        parent[b] = a;
+        if (rnk[a] == rnk[b]) rnk[a]++;
+        return true;
+    }
+};
+
+struct MSTResult {
+    vector<Edge> edges;        // ɭеı
+    long long totalWeight = 0;
+    int trees = 0;             // ͨĸ
+};
+
+/* ---------- Kruskal߰Ȩò鼯μ ---------- */
+MSTResult kruskalMST(int n, vector<Edge> edges) {
+    sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.w < b.w; });
+    UnionFind uf(n);
+    MSTResult r;
+    for (const Edge& e : edges) {
+        if (uf.unite(e.u, e.v)) {
+            r.edges.push_back(e);
+            r.totalWeight += e.w;
+            if ((int)r.edges.size() == n - 1) break;
+        }
+    }
+    r.trees = n - r.edges.size();
+    return r;
+}
+
+/* ----------  Boruvkaÿָ߳ɨһζ㣬 CAS Ϊÿ¼ߣ
+   ٺϲЩ߲±š߰ (Ȩ, С˵, ˵) ȫȽϣ֤ɻ ---------- */
+MSTResult boruvkaMST(const CSRGraph& g, int threads = 0) {
+    int n = g.n;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    const unsigned long long NONE = ~0ULL;
+
+    vector<int> comp(n);
+    for (int v = 0; v < n; v++) comp[v] = v;
+    vector<atomic<unsigned long long>> best(n);   //  32 λΪ㣬 32 λΪ±
+    UnionFind uf(n);
+    MSTResult r;
+
+    auto lighter = [&](int u1, int k1, unsigned long long packed) {
+        int u2 = (int)(packed >> 32), k2 = (int)(packed & 0xFFFFFFFFULL);
+        if (g.weight[k1] != g.weight[k2]) return g.weight[k1] < g.weight[k2];
+        int a1 = min(u1, g.adj[k1]), b1 = max(u1, g.adj[k1]);
+        int a2 = min(u2, g.adj[k2]), b2 = max(u2, g.adj[k2]);
+        return a1 != a2 ? a1 < a2 : b1 < b2;
+        };
+
+    while (true) {
+        for (auto& b : best) b.store(NONE, memory_order_relaxed);
+
+        parallelFor(threads, n, [&](int, int b, int e) {
+            for (int u = b; u < e; u++) {
+                int cu = comp[u];
+                for (int k = g.begin(u); k < g.end(u); k++) {
+                    if (comp[g.adj[k]] == cu) continue;
+                    unsigned long long mine = ((unsigned long long)u << 32) | (unsigned)k;
+                    unsigned long long cur = best[cu].load(memory_order_relaxed);
+                    while ((cur == NONE || lighter(u, k, cur)) &&
+                        !best[cu].compare_exchange_weak(cur, mine)) {}
+                }
+            }
+            });
+
+        int merged = 0;
+        for (int c = 0; c < n; c++) {
+            unsigned long long packed = best[c].load(memory_order_relaxed);
+            if (packed == NONE) continue;
+            int u = (int)(packed >> 32), k = (int)(packed & 0xFFFFFFFFULL);
+            if (uf.unite(u, g.adj[k])) {
+                r.edges.push_back({ u, g.adj[k], g.weight[k] });
+                r.totalWeight += g.weight[k];
+                merged++;
+            }
+        }
+        if (merged == 0) break;
+
+        // find д parent ·ѹܲеã±˳
+        for (int v = 0; v < n; v++) comp[v] = uf.find(v);
+    }
+    r.trees = n - r.edges.size();
+    return r;
+}
+
+/* ===================== ̬ͼԴ· ===================== */
+
+/* ޸ĵͼ߱߱ͬһһ */
+class DynamicGraph {
+public:
+    struct Arc {
+        int to, w;
+    };
+
+    enum UpdateType { INSERT, REMOVE, REWEIGHT };
+    struct Update {
+        UpdateType type;
+        int u, v, w;   // REMOVE ʱ w
+    };
+
+private:
+    int n;
+    vector<vector<Arc>> out, in;
+
+    static Arc* findArc(vector<Arc>& list, int v) {
+        for (Arc& a : list)
+            if (a.to == v) return &a;
+        return nullptr;
+    }
+
+    static void eraseArc(vector<Arc>& list, int v) {
+        for (size_t k = 0; k < list.size(); k++)
+            if (list[k].to == v) { list[k] = list.back(); list.pop_back(); return; }
+    }
+
+public:
+    DynamicGraph(int nodes = 0) : n(nodes), out(nodes), in(nodes) {}
+
+    explicit DynamicGraph(const CSRGraph& g) : n(g.n), out(g.n), in(g.n) {
+        for (int u = 0; u < n; u++)
+            for (int k = g.begin(u); k < g.end(u); k++)
+                insertEdge(u, g.adj[k], g.weight[k]);
+    }
+
+    int size() const { return n; }
+    const vector<Arc>& outArcs(int u) const { return out[u]; }
+    const vector<Arc>& inArcs(int v) const { return in[v]; }
+
+    /* ѴʱȡСȨֵ */
+    void insertEdge(int u, int v, int w) {
+        Arc* a = findArc(out[u], v);
+        if (a) {
+            if (w < a->w) reweight(u, v, w);
+            return;
+        }
+        out[u].push_back({ v, w });
+        in[v].push_back({ u, w });
+    }
+
+    bool removeEdge(int u, int v) {
+        if (!findArc(out[u], v)) return false;
+        eraseArc(out[u], v);
+        eraseArc(in[v], u);
+        return true;
+    }
+
+    bool reweight(int u, int v, int w) {
+        Arc* a = findArc(out[u], v);
+        if (!a) return false;
+        a->w = w;
+        findArc(in[v], u)->w = w;
+        return true;
+    }
+
+    /*  u->v Ȩֵ߲ʱΪ -1 */
+    int weightOf(int u, int v) const {
+        for (const Arc& a : out[u])
+            if (a.to == v) return a.w;
+        return -1;
+    }
+
+    void apply(const Update& up) {
+        if (up.type == INSERT) insertEdge(up.u, up.v, up.w);
+        else if (up.type == REMOVE) removeEdge(up.u, up.v);
+        else reweight(up.u, up.v, up.w);
+    }
+};
+
+/* Դ·ά·ºֻ޸ӰĶ㡣
+   ߱ɾʱߣʹյΪʧЧ¸ѡ룻
+   ߻ıֱɳڣֻЩϼ DijkstraRamalingamCReps ˼· */
+class DynamicSSSP {
+private:
+    DynamicGraph& g;
+    int source;
+    vector<Dist> dist;
+    vector<int> parent;
+    vector<char> invalid;
+    QuadHeap heap;
+    int lastTouched = 0;
+
+    void propagate() {
+        while (!heap.empty()) {
+            pair<Dist, int> top = heap.pop();
+            int u = top.second;
+            if (top.first != dist[u]) continue;
+            lastTouched++;
+            for (const DynamicGraph::Arc& a : g.outArcs(u)) {
+                Dist nd = top.first + a.w;
+                if (nd < dist[a.to]) {
+                    dist[a.to] = nd;
+                    parent[a.to] = u;
+                    heap.push(nd, a.to);
+                }
+            }
+        }
+    }
+
+public:
+    DynamicSSSP(DynamicGraph& graph, int s) : g(graph), source(s) {
+        recompute();
+    }
+
+    const vector<Dist>& distances() const { return dist; }
+    const vector<int>& parents() const { return parent; }
+    int touchedLastBatch() const { return lastTouched; }   // һ³ѵĶ
+
+    /* ---------- ͷ㣨ڳʼͶģ ---------- */
+    void recompute() {
+        int n = g.size();
+        dist.assign(n, DIST_INF);
+        parent.assign(n, -1);
+        invalid.assign(n, 0);
+        heap.clear();
+        lastTouched = 0;
+        dist[source] = 0;
+        heap.push(0, source);
+        propagate();
+    }
+
+    /* ---------- ͼӦһ²޸ ---------- */
+    void applyBatch(const vector<DynamicGraph::Update>& batch) {
+        lastTouched = 0;
+        vector<int> roots;        // ʧЧĸ
+        vector<pair<int, int>> relax;   // Ҫֱɳڵı
+
+        for (const DynamicGraph::Update& up : batch) {
+            int old = g.weightOf(up.u, up.v);
+            g.apply(up);
+            int now = g.weightOf(up.u, up.v);
+            if (old == now) continue;
+            bool worse = now < 0 || (old >= 0 && now > old);
+            if (worse) {
+                if (parent[up.v] == up.u) roots.push_back(up.v);
+            }
+            else relax.push_back({ up.u, up.v });
+        }
+
+        // ռʧЧ = parent[c] == x  x->c Դڵıߣ
+        vector<int> affected;
+        for (int r : roots) {
+            if (invalid[r] || r == source) continue;
+            invalid[r] = 1;
+            affected.push_back(r);
+        }
+        for (size_t i = 0; i < affected.size(); i++) {
+            int x = affected[i];
+            for (const DynamicGraph::Arc& a : g.outArcs(x))
+                if (parent[a.to] == x && !invalid[a.to]) {
+                    invalid[a.to] = 1;
+                    affected.push_back(a.to);
+                }
+        }
+        for (int v : affected) {
+            dist[v] = DIST_INF;
+            parent[v] = -1;
+        }
+
+        // ʧЧȡѡ
+        for (int v : affected) {
+            for (const DynamicGraph::Arc& a : g.inArcs(v)) {
+                if (invalid[a.to] || dist[a.to] == DIST_INF) continue;
+                if (dist[a.to] + a.w < dist[v]) {
+                    dist[v] = dist[a.to] + a.w;
+                    parent[v] = a.to;
+                }
+            }
+            if (dist[v] != DIST_INF) heap.push(dist[v], v);
+        }
+        for (int v : affected) invalid[v] = 0;
+
+        // ı
+        for (const pair<int, int>& e : relax) {
+            int u = e.first, v = e.second;
+            int w = g.weightOf(u, v);   // ͬһпֱɾ
+            if (dist[u] == DIST_INF || w < 0) continue;
+            Dist nd = dist[u] + w;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                heap.push(nd, v);
+            }
+        }
+        propagate();
+    }
+};
+
 /* ===================== ͼ2˫ͨ ===================== */
 
-vector<vector<int>> g2(12);
-vector<int> dfn(12), low2(12);
-set<int> cut;
-int t = 0;
+struct BiconnectedResult {
+    vector<char> isCut;           // ǷΪؽڵ
+    vector<int> articulation;     // ؽڵ㣨
+    vector<int> bridges;          // ţ u0, v0, u1, v1, ... ƽ̴
+    vector<int> arcComponent;     // CSR ÿ˫ͨţͬһߵͬԻΪ -1
+    int componentCount = 0;
+};
+
+/* ----------  Tarjanʽջݹ飬ȫֱһ DFS ͬʱؽڵ㡢ź˫ͨ
+   رֻһᱻఴߴ ---------- */
+BiconnectedResult biconnectedComponents(const CSRGraph& g) {
+    INSTR_SCOPE("tarjan");
+    int n = g.n;
+    BiconnectedResult r;
+    r.isCut.assign(n, 0);
+    r.arcComponent.assign(g.edgeCount(), -1);
+
+    vector<int> dfn(n, 0), low(n, 0), parent(n, -1), parentArc(n, -1), it(n);
+    vector<char> skippedParent(n, 0);
+    vector<int> stk, edgeStk;
+    int timer = 0;
+
+    for (int root = 0; root < n; root++) {
+        if (dfn[root]) continue;
+        dfn[root] = low[root] = ++timer;
+        it[root] = g.begin(root);
+        stk.push_back(root);
+        int rootChildren = 0;
+
+        while (!stk.empty()) {
+            int u = stk.back();
+            if (it[u] < g.end(u)) {
+                int k = it[u]++;
+                int v = g.adj[k];
+                if (v == u) continue;
+                if (v == parent[u] && !skippedParent[u]) { skippedParent[u] = 1; continue; }
+                if (!dfn[v]) {
+                    dfn[v] = low[v] = ++timer;
+                    parent[v] = u;
+                    parentArc[v] = k;
+                    it[v] = g.begin(v);
+                    edgeStk.push_back(k);
+                    stk.push_back(v);
+                    if (u == root) rootChildren++;
+                }
+                else if (dfn[v] < dfn[u]) {
+                    low[u] = min(low[u], dfn[v]);
+                    edgeStk.push_back(k);
+                }
+                continue;
+            }
+
+            // u ھѴ꣬ݵڵ
+            stk.pop_back();
+            int p = parent[u];
+            if (p == -1) continue;
+            low[p] = min(low[p], low[u]);
+            if (low[u] >= dfn[p]) {
+                if (p != root) r.isCut[p] = 1;
+                int id = r.componentCount++;
+                while (true) {
+                    int k = edgeStk.back();
+                    edgeStk.pop_back();
+                    r.arcComponent[k] = id;
+                    if (k == parentArc[u]) break;
+                }
+            }
+            if (low[u] > dfn[p]) {
+                r.bridges.push_back(p);
+                r.bridges.push_back(u);
+            }
+        }
+        if (rootChildren > 1) r.isCut[root] = 1;
+    }
+
+    // DFS ֻÿߵһţһ v ڽӱյжֲ v -> u ȡ
+    for (int u = 0; u < n; u++)
+        for (int k = g.begin(u); k < g.end(u); k++) {
+            int v = g.adj[k];
+            if (r.arcComponent[k] >= 0 || v == u) continue;
+            auto range = equal_range(g.adj + g.begin(v), g.adj + g.end(v), u);
+            for (auto p = range.first; p != range.second; ++p) {
+                int rk = p - g.adj;
+                if (r.arcComponent[rk] >= 0) { r.arcComponent[k] = r.arcComponent[rk]; break; }
+            }
+        }
+
+    for (int v = 0; v < n; v++)
+        if (r.isCut[v]) r.articulation.push_back(v);
+    return r;
+}
+
+/* ===================== ܲ ===================== */
+
+/* ---------- ͨϡͼһٲߣƽԼΪ avgDeg ---------- */
+vector<Edge> randomGraphEdges(int n, int avgDeg, int maxW, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> wdist(1, maxW);
+    vector<Edge> edges;
+    edges.reserve((size_t)n * avgDeg / 2 + n);
+    for (int v = 1; v < n; v++)
+        edges.push_back({ (int)(rng() % v), v, wdist(rng) });
+    long long extra = (long long)n * avgDeg / 2 - (n - 1);
+    for (long long i = 0; i < extra; i++)
+        edges.push_back({ (int)(rng() % n), (int)(rng() % n), wdist(rng) });
+    return edges;
+}
+
+void benchDijkstra(int n, int avgDeg) {
+    CSRGraph g = buildCSR(n, randomGraphEdges(n, avgDeg, 1000, 12345));
+    cout << "\nDijkstra : n = " << n << ",  = " << g.edgeCount() << endl;
+
+    const char* names[] = { "4", "Զ", "" };
+    HeapKind kinds[] = { HEAP_QUAD, HEAP_PAIRING, HEAP_RADIX };
+    vector<Dist> ref;
+    for (int i = 0; i < 3; i++) {
+        vector<Dist> dist;
+        vector<int> pred;
+        auto start = chrono::high_resolution_clock::now();
+        shortestPaths(g, 0, dist, pred, kinds[i]);
+        auto end = chrono::high_resolution_clock::now();
+        if (i == 0) ref = dist;
+        cout << names[i] << " | ʱ(ms): " << chrono::duration<double, milli>(end - start).count()
+            << (dist == ref ? "" : " | һ!") << endl;
+    }
+}
+
+/* ---------- Ȩͼ0..n-2 ɱȨΪ 1 ·һȨΪ heavyW ıߴ 0  n-1
+   Զ delta Ϊ 1һڵ heavyW Ͱ ---------- */
+vector<Edge> heavyEdgePathEdges(int n, int heavyW) {
+    vector<Edge> edges;
+    for (int v = 1; v + 1 < n; v++) edges.push_back({ v - 1, v, 1 });
+    edges.push_back({ 0, n - 1, heavyW });
+    return edges;
+}
+
+/* ---------- delta-stepping ߳չԣ 4  Dijkstra ȶԾ ---------- */
+void benchDeltaStepping(const string& name, const CSRGraph& g) {
+    cout << "\ndelta-stepping : " << name << ", n = " << g.n << ",  = " << g.edgeCount()
+        << ", Զ delta = " << tuneDelta(g) << endl;
+    vector<Dist> ref;
+    vector<int> pred;
+    auto t0 = chrono::high_resolution_clock::now();
+    shortestPaths(g, 0, ref, pred);
+    double base = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+    cout << "Dijkstra     | ʱ(ms): " << base << endl;
+
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    bool ok = true;
+    double single = 0;
+    for (int t = 1; ; t = min(t * 2, maxThreads)) {
+        t0 = chrono::high_resolution_clock::now();
+        vector<Dist> dist = deltaStepping(g, 0, t);
+        double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+        if (t == 1) single = ms;
+        ok = ok && dist == ref;
+        cout << "߳ " << t << (t < 10 ? "     " : "    ") << "| ʱ(ms): " << ms << " |  Dijkstra: " << base / ms
+            << "x | Ե߳: " << single / ms << "x" << endl;
+        if (t == maxThreads) break;
+    }
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
+}
+
+/* ---------- ͼȫԴ· FloydCWarshallֿ汾߳ / ̣߳Դ Dijkstra㣩 ---------- */
+void benchFloydWarshall(int n, int densityPercent) {
+    mt19937 rng(2468);
+    vector<vector<int>> g(n, vector<int>(n, INF));
+    vector<Edge> edges;
+    for (int i = 0; i < n; i++) {
+        g[i][i] = 0;
+        for (int j = 0; j < n; j++)
+            if (i != j && (int)(rng() % 100) < densityPercent) {
+                g[i][j] = 1 + rng() % 1000;
+                edges.push_back({ i, j, g[i][j] });
+            }
+    }
+    cout << "\nȫԴ·: n = " << n << ",  = " << edges.size()
+#ifdef __AVX2__
+        << ", ں: AVX2" << endl;
+#else
+        << ", ں: " << endl;
+#endif
+
+    vector<vector<int>> ref = g;
+    auto t0 = chrono::high_resolution_clock::now();
+    floydWarshall(ref);
+    double naive = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+    cout << " FloydCWarshall     | ʱ(ms): " << naive << endl;
+
+    bool ok = true;
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    for (int t : { 1, maxThreads }) {
+        DistMatrix m = DistMatrix::fromAdjacency(g);
+        t0 = chrono::high_resolution_clock::now();
+        floydWarshallBlocked(m, t);
+        double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+        ok = ok && m.toVector() == ref;
+        cout << "ֿ FloydCWarshall " << t << " ߳ | ʱ(ms): " << ms << " | : " << naive / ms << "x" << endl;
+        if (maxThreads == 1) break;
+    }
+
+    // Դ Dijkstra ֻ̫ɸԴٰԴ
+    CSRGraph csr = buildCSR(n, edges, false);
+    const int samples = 20;
+    t0 = chrono::high_resolution_clock::now();
+    for (int s = 0; s < samples; s++) {
+        vector<Dist> dist;
+        vector<int> pred;
+        shortestPaths(csr, s, dist, pred);
+        for (int v = 0; v < n; v++)
+            ok = ok && (dist[v] == DIST_INF ? INF : dist[v]) == ref[s][v];
+    }
+    double dijkstra = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count() / samples * n;
+    cout << "Դ Dijkstra㣩   | ʱ(ms): " << dijkstra << endl;
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
+}
+
+void benchQueryEngine(int n, int avgDeg, int queryCount) {
+    CSRGraph g = buildCSR(n, randomGraphEdges(n, avgDeg, 1000, 12345));
+    ShortestPathEngine engine(g);
+    mt19937 rng(2024);
+    vector<pair<int, int>> queries(queryCount);
+    for (auto& q : queries) q = { (int)(rng() % n), (int)(rng() % n) };
+    cout << "\nԵѯ: n = " << n << ", ѯ = " << queryCount
+        << ", ߳ = " << engine.threadCount() << endl;
+
+    //  Dijkstra 
+    int check = min(queryCount, 5);
+    bool ok = true;
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < check; i++) {
+        vector<Dist> dist;
+        vector<int> pred;
+        shortestPaths(g, queries[i].first, dist, pred);
+        if (dist[queries[i].second] != engine.query(queries[i].first, queries[i].second)) ok = false;
+    }
+    auto mid = chrono::high_resolution_clock::now();
+
+    vector<Dist> out;
+    engine.queryBatch(queries, out);
+    auto end = chrono::high_resolution_clock::now();
+
+    double full = chrono::duration<double, milli>(mid - start).count() / check;
+    double batch = chrono::duration<double, milli>(end - mid).count();
+    cout << " Dijkstra ÿ(ms): " << full << endl;
+    cout << "˫ѯʱ(ms): " << batch << " | ÿѯ: " << queryCount / (batch / 1000) << endl;
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
+}
+
+/* ---------- ͼ·rows x cols 㣬ڸ֮ ---------- */
+vector<Edge> gridGraphEdges(int rows, int cols, int maxW, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> wdist(1, maxW);
+    vector<Edge> edges;
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++) {
+            int v = r * cols + c;
+            if (c + 1 < cols) edges.push_back({ v, v + 1, wdist(rng) });
+            if (r + 1 < rows) edges.push_back({ v, v + cols, wdist(rng) });
+        }
+    return edges;
+}
+
+void benchContractionHierarchy(int rows, int cols, int queryCount) {
+    int n = rows * cols;
+    CSRGraph g = buildCSR(n, gridGraphEdges(rows, cols, 100, 777));
+    cout << "\nβ: " << rows << " x " << cols << " , n = " << n << endl;
+
+    const string path = "ch_bench.bin";
+    auto t0 = chrono::high_resolution_clock::now();
+    {
+        ContractionHierarchy ch;
+        if (!ch.build(g)) { cout << "Ԥʧ: ݾȳ 32 λȨ" << endl; return; }
+        ch.save(path);
+        cout << "ϱ(ݾ): " << ch.arcCount() << endl;
+    }
+    auto t1 = chrono::high_resolution_clock::now();
+    ContractionHierarchy ch;
+    bool loaded = ch.load(path);
+    auto t2 = chrono::high_resolution_clock::now();
+    cout << "Ԥ(ms): " << chrono::duration<double, milli>(t1 - t0).count()
+        << " | ӳ(ms): " << chrono::duration<double, milli>(t2 - t1).count() << endl;
+    if (!loaded) { cout << "ʧ" << endl; return; }
+
+    mt19937 rng(99);
+    vector<pair<int, int>> queries(queryCount);
+    for (auto& q : queries) q = { (int)(rng() % n), (int)(rng() % n) };
+
+    int check = min(queryCount, 5);
+    bool ok = true;
+    auto t3 = chrono::high_resolution_clock::now();
+    for (int i = 0; i < check; i++) {
+        vector<Dist> dist;
+        vector<int> pred;
+        shortestPaths(g, queries[i].first, dist, pred);
+        if (dist[queries[i].second] != ch.query(queries[i].first, queries[i].second)) ok = false;
+    }
+    auto t4 = chrono::high_resolution_clock::now();
+    Dist sum = 0;
+    for (auto& q : queries) sum += ch.query(q.first, q.second);
+    auto t5 = chrono::high_resolution_clock::now();
+
+    double plain = chrono::duration<double, milli>(t4 - t3).count() / check;
+    double fast = chrono::duration<double, milli>(t5 - t4).count() / queryCount;
+    cout << "Dijkstra ÿ(ms): " << plain << " | CH ÿ(ms): " << fast
+        << " | ٱ: " << plain / fast << endl;
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
+    remove(path.c_str());
+}
+
+/* ---------- R-MAT ͼGraph500  a=0.57, b=c=0.192^scale 㣬edgeFactor * 2^scale ߣ ---------- */
+vector<Edge> rmatEdges(int scale, int edgeFactor, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> uni(0.0, 1.0);
+    int n = 1 << scale;
+    vector<int> perm(n);
+    for (int i = 0; i < n; i++) perm[i] = i;
+    shuffle(perm.begin(), perm.end(), rng);
+
+    vector<Edge> edges((size_t)edgeFactor * n);
+    for (Edge& e : edges) {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            double p = uni(rng);
+            if (p < 0.57) {}
+            else if (p < 0.76) v |= 1 << bit;
+            else if (p < 0.95) u |= 1 << bit;
+            else { u |= 1 << bit; v |= 1 << bit; }
+        }
+        e = { perm[u], perm[v], 1 };
+    }
+    return edges;
+}
+
+// ͼϱȶͨ BFS 뷽Ż BFS Ĳ͸ڵ㣬Ƿһ£in Ϊ߱
+bool benchBFSCase(const string& name, const CSRGraph& g, const CSRGraph& in, bool undirected, int roots, int threads) {
+    int n = g.n;
+    cout << name << ":  = " << g.edgeCount() << endl;
+    mt19937 rng(7);
+    double serialTime = 0, fastTime = 0;
+    long long traversed = 0;
+    bool ok = true;
+    for (int i = 0; i < roots; i++) {
+        int src;
+        do src = rng() % n; while (g.begin(src) == g.end(src));
+
+        // գͨ BFS
+        auto t0 = chrono::high_resolution_clock::now();
+        vector<int> level(n, -1);
+        vector<int> q = { src };
+        level[src] = 0;
+        for (size_t h = 0; h < q.size(); h++)
+            for (int k = g.begin(q[h]); k < g.end(q[h]); k++)
+                if (level[g.adj[k]] < 0) {
+                    level[g.adj[k]] = level[q[h]] + 1;
+                    q.push_back(g.adj[k]);
+                }
+        auto t1 = chrono::high_resolution_clock::now();
+        BFSResult r = parallelBFS(g, src, threads, &in);
+        auto t2 = chrono::high_resolution_clock::now();
+
+        serialTime += chrono::duration<double>(t1 - t0).count();
+        fastTime += chrono::duration<double>(t2 - t1).count();
+        if (r.level != level) ok = false;
+        //  v ǳһ㣬 parent[v] -> v ȷʵͼеĻ
+        for (int v = 0; v < n && ok; v++) {
+            if (v == src || r.level[v] <= 0) continue;
+            int p = r.parent[v];
+            if (p < 0 || p >= n || level[p] != level[v] - 1) ok = false;
+            else if (find(g.adj + g.begin(p), g.adj + g.end(p), v) == g.adj + g.end(p)) ok = false;
+        }
+        for (int v : q) traversed += g.end(v) - g.begin(v);
+        if (i == 0)
+            cout << "Զ²: " << r.topDownSteps << ", Եϲ: " << r.bottomUpSteps << endl;
+    }
+    if (undirected) traversed /= 2;   // ֻһ
+    cout << "ͨ BFS     | ÿ(ms): " << serialTime * 1000 / roots << " | TEPS: " << traversed / serialTime << endl;
+    cout << "Ż BFS | ÿ(ms): " << fastTime * 1000 / roots << " | TEPS: " << traversed / fastTime << endl;
+    return ok;
+}
+
+void benchBFS(int scale, int edgeFactor, int roots) {
+    int n = 1 << scale;
+    int threads = max(1u, thread::hardware_concurrency());
+    cout << "\nBFS : R-MAT scale = " << scale << ",  = " << n << ", ߳ = " << threads << endl;
+    vector<Edge> edges = rmatEdges(scale, edgeFactor, 4242);
+
+    CSRGraph g = buildCSR(n, edges);
+    bool ok = benchBFSCase("ͼ", g, g, true, roots, threads);
+
+    // ͼԵ reverseCSR Ҹڵ
+    CSRGraph dg = buildCSR(n, edges, false);
+    CSRGraph rev = reverseCSR(dg);
+    ok = benchBFSCase("ͼ", dg, rev, false, roots, threads) && ok;
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
+}
+
+void benchBiconnected(int pathLength, int n, int avgDeg) {
+    cout << "\n˫ͨ" << endl;
+    // DFS ȵڶݹʵֻջ
+    vector<Edge> chain;
+    for (int v = 1; v < pathLength; v++) chain.push_back({ v - 1, v, 1 });
+    CSRGraph g = buildCSR(pathLength, chain);
+    auto t0 = chrono::high_resolution_clock::now();
+    BiconnectedResult r = biconnectedComponents(g);
+    auto t1 = chrono::high_resolution_clock::now();
+    cout << " n = " << pathLength << " | ʱ(ms): " << chrono::duration<double, milli>(t1 - t0).count()
+        << " | ؽڵ: " << r.articulation.size() << " | : " << r.bridges.size() / 2 << endl;
+
+    g = buildCSR(n, randomGraphEdges(n, avgDeg, 1, 31337));
+    t0 = chrono::high_resolution_clock::now();
+    r = biconnectedComponents(g);
+    t1 = chrono::high_resolution_clock::now();
+    cout << "ͼ n = " << n << ",  = " << g.edgeCount() / 2
+        << " | ʱ(ms): " << chrono::duration<double, milli>(t1 - t0).count()
+        << " | ؽڵ: " << r.articulation.size() << " | : " << r.bridges.size() / 2
+        << " | : " << r.componentCount << endl;
+}
+
+void benchMST(const string& name, int n, const vector<Edge>& edges, bool runPrim) {
+    CSRGraph g = buildCSR(n, edges);
+    cout << name << " n = " << n << ",  = " << edges.size() << endl;
+
+    auto t0 = chrono::high_resolution_clock::now();
+    MSTResult k = kruskalMST(n, edges);
+    auto t1 = chrono::high_resolution_clock::now();
+    MSTResult b = boruvkaMST(g);
+    auto t2 = chrono::high_resolution_clock::now();
+    cout << "Kruskal | ʱ(ms): " << chrono::duration<double, milli>(t1 - t0).count()
+        << " | Ȩֵ: " << k.totalWeight << " | : " << k.trees << endl;
+    cout << "Boruvka | ʱ(ms): " << chrono::duration<double, milli>(t2 - t1).count()
+        << " | Ȩֵ: " << b.totalWeight << " | : " << b.trees << endl;
+    if (runPrim) {
+        long long p = primWeight(g);
+        auto t3 = chrono::high_resolution_clock::now();
+        cout << "Prim    | ʱ(ms): " << chrono::duration<double, milli>(t3 - t2).count()
+            << " | Ȩֵ: " << p << endl;
+    }
+}
+
+void benchMSTAll() {
+    cout << "\nС" << endl;
+    // ͼȫͼ
+    int dn = 2000;
+    mt19937 rng(5);
+    vector<Edge> dense;
+    for (int u = 0; u < dn; u++)
+        for (int v = u + 1; v < dn; v++) dense.push_back({ u, v, (int)(rng() % 100000) });
+    benchMST("ͼ", dn, dense, true);
+
+    benchMST("ϡͼ", 20000, randomGraphEdges(20000, 8, 100000, 6), true);
+    benchMST("ϡͼ", 1000000, randomGraphEdges(1000000, 8, 100000, 7), false);
 
-void add2(int a, int b) {
-    g2[a].push_back(b);
-    g2[b].push_back(a);
+    // ͨͼƴһ
+    vector<Edge> twoParts = randomGraphEdges(10000, 6, 1000, 8);
+    for (const Edge& e : randomGraphEdges(10000, 6, 1000, 9)) twoParts.push_back({ e.u + 10000, e.v + 10000, e.w });
+    benchMST("ͨͼ", 20000, twoParts, true);
 }
 
-void tarjan(int u, int fa) {
-    dfn[u] = low2[u] = ++t;
-    int child = 0;
+void benchGraphFile(int n, int avgDeg) {
+    cout << "\nͼļ" << endl;
+    const string textPath = "graph_bench.txt", binPath = "graph_bench.bin";
+    vector<Edge> edges = randomGraphEdges(n, avgDeg, 1000, 4321);
+    {
+        ofstream out(textPath);
+        for (const Edge& e : edges) out << e.u << ' ' << e.v << ' ' << e.w << '\n';
+    }
+
+    auto t0 = chrono::high_resolution_clock::now();
+    bool ok = convertEdgeList(textPath, binPath);
+    auto t1 = chrono::high_resolution_clock::now();
+    CSRGraph g;
+    ok = ok && loadCSR(binPath, g);
+    auto t2 = chrono::high_resolution_clock::now();
+    cout << "߱ı(" << edges.size() << " ) ->  CSR(ms): " << chrono::duration<double, milli>(t1 - t0).count()
+        << " | ӳ(ms): " << chrono::duration<double, milli>(t2 - t1).count() << endl;
 
-    for (int v : g2[u]) {
-        if (!dfn[v]) {
-            child++;
-            tarjan(v, u);
-            low2[u] = min(low2[u], low2[v]);
-            if (fa != -1 && low2[v] >= dfn[u])
-                cut.insert(u);
+    if (ok) {
+        CSRGraph ref = buildCSR(n, edges);
+        ok = g.n == ref.n && g.edgeCount() == ref.edgeCount() &&
+            equal(ref.adj, ref.adj + ref.edgeCount(), g.adj) &&
+            equal(ref.weight, ref.weight + ref.edgeCount(), g.weight);
+    }
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
+    g = CSRGraph();
+    remove(textPath.c_str());
+    remove(binPath.c_str());
+}
+
+/* ---------- £롢ɾȨռ֮һ ---------- */
+vector<DynamicGraph::Update> randomUpdates(const DynamicGraph& g, int count, int maxW, mt19937& rng) {
+    vector<DynamicGraph::Update> batch;
+    int n = g.size();
+    while ((int)batch.size() < count) {
+        int u = rng() % n;
+        int kind = rng() % 3;
+        int w = 1 + rng() % maxW;
+        if (kind == 0) batch.push_back({ DynamicGraph::INSERT, u, (int)(rng() % n), w });
+        else if (!g.outArcs(u).empty()) {
+            int v = g.outArcs(u)[rng() % g.outArcs(u).size()].to;
+            batch.push_back({ kind == 1 ? DynamicGraph::REMOVE : DynamicGraph::REWEIGHT, u, v, w });
         }
-        else if (v != fa)
-            low2[u] = min(low2[u], dfn[v]);
     }
+    return batch;
+}
+
+void benchDynamicSSSP(int n, int avgDeg, int rounds) {
+    cout << "\n·: n = " << n << endl;
+    DynamicGraph g(buildCSR(n, randomGraphEdges(n, avgDeg, 1000, 2468)));
+    DynamicSSSP inc(g, 0);
+    mt19937 rng(13579);
+
+    int batchSizes[] = { 1, 10, 100, 1000, 10000 };
+    bool ok = true;
+    for (int size : batchSizes) {
+        double incTime = 0, fullTime = 0;
+        long long touched = 0;
+        for (int r = 0; r < rounds; r++) {
+            vector<DynamicGraph::Update> batch = randomUpdates(g, size, 1000, rng);
+            auto t0 = chrono::high_resolution_clock::now();
+            inc.applyBatch(batch);
+            auto t1 = chrono::high_resolution_clock::now();
+            touched += inc.touchedLastBatch();
 
-    if (fa == -1 && child > 1)
-        cut.insert(u);
+            DynamicSSSP full(g, 0);   // ģȫ
+            auto t2 = chrono::high_resolution_clock::now();
+            if (full.distances() != inc.distances()) ok = false;
+            incTime += chrono::duration<double, milli>(t1 - t0).count();
+            fullTime += chrono::duration<double, milli>(t2 - t1).count();
+        }
+        cout << "ÿ " << size << "  | (ms): " << incTime / rounds
+            << " | ȫ(ms): " << fullTime / rounds
+            << " | ƽ³Ѷ: " << touched / rounds << endl;
+    }
+    cout << "У: " << (ok ? "һ" : "һ!") << endl;
 }
 
 /* =====================  ===================== */
 
-int main() {
+int main(int argc, char* argv[]) {
+    /* ܲģʽmain bench */
+    if (argc > 1 && string(argv[1]) == "bench") {
+        benchDijkstra(100000, 8);
+        benchDijkstra(1000000, 8);
+        benchDeltaStepping("ͼ", buildCSR(1000000, randomGraphEdges(1000000, 8, 1000, 12345)));
+        benchDeltaStepping("ͼ", buildCSR(1000000, gridGraphEdges(1000, 1000, 1000, 7)));
+        benchDeltaStepping("ر·", buildCSR(100000, heavyEdgePathEdges(100000, 2000000000)));
+        benchQueryEngine(1000000, 8, 1000);
+        benchFloydWarshall(1500, 50);
+        benchContractionHierarchy(1000, 1000, 10000);
+        benchBFS(20, 16, 8);
+        benchBiconnected(10000000, 4000000, 10);
+        benchMSTAll();
+        benchGraphFile(1000000, 8);
+        benchDynamicSSSP(200000, 8, 10);
+        return 0;
+    }
+
+    /* ͼļģʽmain convert ߱.txt ͼ.binı߱תΪ CSRmain info ͼ.binӳһ BFS */
+    if (argc > 3 && string(argv[1]) == "convert") {
+        if (!convertEdgeList(argv[2], argv[3])) { cout << "תʧ" << endl; return 1; }
+        return 0;
+    }
+    if (argc > 2 && string(argv[1]) == "info") {
+        CSRGraph g;
+        auto t0 = chrono::high_resolution_clock::now();
+        if (!loadCSR(argv[2], g)) { cout << "ʧ" << endl; return 1; }
+        auto t1 = chrono::high_resolution_clock::now();
+        int reached = 0, depth = 0;
+        if (g.n > 0) {
+            BFSResult r = parallelBFS(g, 0);
+            for (int x : r.level) if (x >= 0) reached++, depth = max(depth, x);
+        }
+        cout << ": " << g.n << " | : " << g.edgeCount()
+            << " | (ms): " << chrono::duration<double, milli>(t1 - t0).count()
+            << " |  0 ɴ: " << reached << " | BFS : " << depth << endl;
+        return 0;
+    }
+
     for (int i = 0; i < v1.size(); i++) idx1[v1[i]] = i;
 
     auto g1 = buildGraph1();
+    CSRGraph csr1 = buildCSR(v1.size(), graph1Edges());
 
     /* (1) ڽӾ */
     printMatrix(g1);
 
     /* (2) BFS / DFS */
-    BFS(g1, idx1['A']);
-    DFS(g1, idx1['A']);
+    BFS(csr1, idx1['A']);
+    DFS(csr1, idx1['A']);
 
     /* (3) · + С */
-    Dijkstra(g1, idx1['A']);
-    Prim(g1);
+    Dijkstra(csr1, idx1['A']);
+    Prim(csr1);
+
+    MSTResult mst = kruskalMST(v1.size(), graph1Edges());
+    cout << "Kruskal С: ";
+    for (const Edge& e : mst.edges)
+        cout << v1[e.u] << "-" << v1[e.v] << "(" << e.w << ") ";
+    cout << "| Ȩֵ: " << mst.totalWeight << endl;
 
     /* (4) ͼ2˫ͨؽڵ㣩 */
+    vector<Edge> edges2;
+    auto add2 = [&](int a, int b) {
+        edges2.push_back({ a, b, 1 });
+        };
+
     add2(0, 1); add2(1, 2); add2(2, 3);
     add2(0, 4); add2(4, 5); add2(5, 6); add2(6, 2);
     add2(2, 7); add2(5, 9); add2(9, 10);
     add2(10, 11); add2(6, 10); add2(4, 8);
 
-    tarjan(0, -1);
+    CSRGraph g2 = buildCSR(12, edges2);
+    BiconnectedResult bcc = biconnectedComponents(g2);
 
     cout << "ͼ2ؽڵ㣺";
-    for (int x : cut)
+    for (int x : bcc.articulation)
         cout << char('A' + x) << " ";
     cout << endl;
 
+    cout << "ͼ2ţ";
+    for (size_t i = 0; i < bcc.bridges.size(); i += 2)
+        cout << char('A' + bcc.bridges[i]) << "-" << char('A' + bcc.bridges[i + 1]) << " ";
+    cout << endl;
+    cout << "ͼ2˫ͨ" << bcc.componentCount << endl;
+
     return 0;
-}
+}
\ No newline at end of file
@@ -4,9 +4,46 @@
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <new>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
+#include "../common/instrument.h"
 using namespace std;
 
+// ======================= ѷ =======================
+// 滻ȫ operator new/deleteͳƽڵĶѷ֤Ԥ֮ÿ֡
+static atomic<long long> heapAllocations{ 0 };
+
+void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+// delete GCC  free ׼ new Լ飬 -Wmismatched-new-delete
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+void* operator new[](size_t size) { return operator new(size); }
+NOINLINE void operator delete(void* p) noexcept { free(p); }
+NOINLINE void operator delete[](void* p) noexcept { free(p); }
+NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+NOINLINE void operator delete[](void* p, size_t) noexcept { free(p); }
+
 // ======================= ߽ṹ =======================
 struct Box {
     float x1, y1, x2, y2;
@@ -31,7 +68,9 @@ float IoU(const Box& a, const Box& b) {
 }
 
 // ======================= NMS =======================
-vector<Box> NMS(vector<Box>& boxes, float threshold) {
+vector<Box> NMS(const vector<Box>& boxes, float threshold) {
+    INSTR_SCOPE("NMS");
+    INSTR_HIST("NMS.boxes", boxes.size());
     vector<Box> result;
     vector<bool> suppressed(boxes.size(), false);
 
@@ -48,6 +87,430 @@ vector<Box> NMS(vector<Box>& boxes, float threshold) {
     return result;
 }
 
+// =======================  NMS =======================
+//  NMS ȫһ£˳һ򱻱ҽ֮ǰѱ IoU ֵ
+// ѱĵǼھIoU > t Ҫ x صȳ t 
+// ƺѡѱıںѡ max(0, 0.5 - t) ķΧڣy ͬ
+// ֻɨһΧǵĸӡֵ < 0 ʱཻĿҲụƣʱ˻ NMS
+class GridNMS {
+public:
+    void run(const vector<Box>& boxes, float threshold, vector<Box>& out);
+
+private:
+    struct Entry {
+        float cx, cy;
+        int box;
+        int next;
+    };
+    float minX = 0, minY = 0, cell = 1;
+    int gx = 1, gy = 1;
+    vector<int> cellHead;   // ÿӵĵǼͷ
+    vector<Entry> entries;
+
+    int cellOf(float v, float lo, int cnt) const {
+        float c = (v - lo) / cell;
+        if (!(c > 0)) return 0;
+        return c >= cnt - 1 ? cnt - 1 : (int)c;
+    }
+};
+
+void GridNMS::run(const vector<Box>& boxes, float threshold, vector<Box>& out) {
+    out.clear();
+    int n = (int)boxes.size();
+    if (n == 0) return;
+    if (threshold < 0) { out = NMS(boxes, threshold); return; }
+
+    float maxX = boxes[0].x1, maxY = boxes[0].y1;
+    minX = maxX; minY = maxY;
+    float maxW = 0, maxH = 0;
+    double sizeSum = 0;
+    for (const Box& b : boxes) {
+        minX = min(minX, min(b.x1, b.x2)); maxX = max(maxX, max(b.x1, b.x2));
+        minY = min(minY, min(b.y1, b.y2)); maxY = max(maxY, max(b.y1, b.y2));
+        float bw = fabs(b.x2 - b.x1), bh = fabs(b.y2 - b.y1);
+        maxW = max(maxW, bw); maxH = max(maxH, bh);
+        sizeSum += max(bw, bh);
+    }
+    // չ 0.1%  IoU 
+    float slack = max(0.0f, 0.5f - threshold) + 0.001f;
+    float padX = slack * maxW, padY = slack * maxH;
+
+    // ӱ߳ȡƽߴķ֮һٶΧܴʱŴӣø 4n
+    double w = (double)maxX - minX, h = (double)maxY - minY;
+    double c = max(sizeSum / n / 4, sqrt(w * h / (4.0 * n)));
+    c = max(c, max(w, h) / 4096);
+    if (!(c > 0)) c = 1;
+    cell = (float)c;
+    gx = (int)(w / c) + 1;
+    gy = (int)(h / c) + 1;
+
+    cellHead.assign((size_t)gx * gy, -1);
+    entries.clear();
+
+    for (int i = 0; i < n; i++) {
+        const Box& b = boxes[i];
+        float qx1 = min(b.x1, b.x2) - padX, qx2 = max(b.x1, b.x2) + padX;
+        float qy1 = min(b.y1, b.y2) - padY, qy2 = max(b.y1, b.y2) + padY;
+        int cx0 = cellOf(qx1, minX, gx), cx1 = cellOf(qx2, minX, gx);
+        int cy0 = cellOf(qy1, minY, gy), cy1 = cellOf(qy2, minY, gy);
+
+        bool keep = true;
+        for (int y = cy0; y <= cy1 && keep; y++)
+            for (int x = cx0; x <= cx1 && keep; x++)
+                for (int e = cellHead[(size_t)y * gx + x]; e >= 0; e = entries[e].next) {
+                    const Entry& en = entries[e];
+                    if (en.cx < qx1 || en.cx > qx2 || en.cy < qy1 || en.cy > qy2) continue;
+                    if (IoU(boxes[en.box], b) > threshold) { keep = false; break; }
+                }
+        if (!keep) continue;
+
+        out.push_back(b);
+        float cx = (b.x1 + b.x2) * 0.5f, cy = (b.y1 + b.y2) * 0.5f;
+        int& head = cellHead[(size_t)cellOf(cy, minY, gy) * gx + cellOf(cx, minX, gx)];
+        entries.push_back({ cx, cy, i, head });
+        head = (int)entries.size() - 1;
+    }
+}
+
+vector<Box> gridNMS(const vector<Box>& boxes, float threshold) {
+    GridNMS engine;
+    vector<Box> result;
+    engine.run(boxes, threshold, result);
+    return result;
+}
+
+// ======================= λ NMS =======================
+// ṹ飨SoAŵĿԤáŲڵ÷һڴϣ
+// Ȳ뵽 64 ıĿΪ 0κο IoU ᳬǸֵ
+struct BoxSoA {
+    float *x1 = nullptr, *y1 = nullptr, *x2 = nullptr, *y2 = nullptr, *score = nullptr, *area = nullptr;
+    int n = 0;
+    size_t padded = 0;
+
+    static size_t paddedSize(size_t count) { return (count + 63) / 64 * 64; }
+    // Ҫڴ棺6 飬ÿ paddedSize(count)  float
+    static size_t floatsFor(size_t count) { return 6 * paddedSize(count); }
+
+    void assign(const Box* boxes, int count, float* mem) {
+        n = count;
+        padded = paddedSize(count);
+        float** arrays[] = { &x1, &y1, &x2, &y2, &score, &area };
+        for (int k = 0; k < 6; k++) *arrays[k] = mem + k * padded;
+        fill(mem, mem + 6 * padded, 0.0f);
+        for (int i = 0; i < n; i++) {
+            const Box& b = boxes[i];
+            x1[i] = b.x1; y1[i] = b.y1; x2[i] = b.x2; y2[i] = b.y2; score[i] = b.score;
+            area[i] = (b.x2 - b.x1) * (b.y2 - b.y1);
+        }
+    }
+};
+
+//  i  [base, base + 64)  64  IoU Ƿ񳬹ֵ k λӦ base + k
+// ˳ IoU() ͬҲ汾λһ
+uint64_t suppressMask(const BoxSoA& s, int i, size_t base, float threshold) {
+    uint64_t mask = 0;
+#if defined(__AVX512F__)
+    const __m512 ax1 = _mm512_set1_ps(s.x1[i]), ay1 = _mm512_set1_ps(s.y1[i]);
+    const __m512 ax2 = _mm512_set1_ps(s.x2[i]), ay2 = _mm512_set1_ps(s.y2[i]);
+    const __m512 aArea = _mm512_set1_ps(s.area[i]), thr = _mm512_set1_ps(threshold), zero = _mm512_setzero_ps();
+    for (int k = 0; k < 64; k += 16) {
+        size_t j = base + k;
+        __m512 w = _mm512_max_ps(_mm512_sub_ps(_mm512_min_ps(ax2, _mm512_loadu_ps(&s.x2[j])), _mm512_max_ps(ax1, _mm512_loadu_ps(&s.x1[j]))), zero);
+        __m512 h = _mm512_max_ps(_mm512_sub_ps(_mm512_min_ps(ay2, _mm512_loadu_ps(&s.y2[j])), _mm512_max_ps(ay1, _mm512_loadu_ps(&s.y1[j]))), zero);
+        __m512 inter = _mm512_mul_ps(w, h);
+        __m512 uni = _mm512_sub_ps(_mm512_add_ps(aArea, _mm512_loadu_ps(&s.area[j])), inter);
+        __mmask16 gt = _mm512_cmp_ps_mask(_mm512_div_ps(inter, uni), thr, _CMP_GT_OQ);
+        mask |= (uint64_t)gt << k;
+    }
+#elif defined(__AVX2__)
+    const __m256 ax1 = _mm256_set1_ps(s.x1[i]), ay1 = _mm256_set1_ps(s.y1[i]);
+    const __m256 ax2 = _mm256_set1_ps(s.x2[i]), ay2 = _mm256_set1_ps(s.y2[i]);
+    const __m256 aArea = _mm256_set1_ps(s.area[i]), thr = _mm256_set1_ps(threshold), zero = _mm256_setzero_ps();
+    for (int k = 0; k < 64; k += 8) {
+        size_t j = base + k;
+        __m256 w = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(ax2, _mm256_loadu_ps(&s.x2[j])), _mm256_max_ps(ax1, _mm256_loadu_ps(&s.x1[j]))), zero);
+        __m256 h = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(ay2, _mm256_loadu_ps(&s.y2[j])), _mm256_max_ps(ay1, _mm256_loadu_ps(&s.y1[j]))), zero);
+        __m256 inter = _mm256_mul_ps(w, h);
+        __m256 uni = _mm256_sub_ps(_mm256_add_ps(aArea, _mm256_loadu_ps(&s.area[j])), inter);
+        int gt = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_div_ps(inter, uni), thr, _CMP_GT_OQ));
+        mask |= (uint64_t)gt << k;
+    }
+#else
+    for (int k = 0; k < 64; k++) {
+        size_t j = base + k;
+        float w = max(0.0f, min(s.x2[i], s.x2[j]) - max(s.x1[i], s.x1[j]));
+        float h = max(0.0f, min(s.y2[i], s.y2[j]) - max(s.y1[i], s.y1[j]));
+        float inter = w * h;
+        if (inter / (s.area[i] + s.area[j] - inter) > threshold) mask |= 1ULL << k;
+    }
+#endif
+    return mask;
+}
+
+const char* suppressKernelName() {
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "";
+#endif
+}
+
+//  NMS ȫһ£״̬ 64 λһ¼ removed У GPU ϵ NMS ͬ
+// ÿһ򣬾Ͱ 64 һԺ벢 removedȫƵֱ
+// 󲿷ֿصʱclusteredBoxesֻͷҪɨ顣
+// removed  soa.padded / 64 ֣±д keptmaxKeep > 0 ʱ maxKeep ֹͣر
+int maskSuppress(const BoxSoA& soa, float threshold, uint64_t* removed, int* kept, int maxKeep = 0) {
+    size_t words = soa.padded / 64;
+    fill(removed, removed + words, 0ULL);
+    int count = 0;
+    for (int i = 0; i < soa.n; i++) {
+        size_t w0 = i / 64;
+        if (removed[w0] >> (i & 63) & 1) continue;
+        kept[count++] = i;
+        if (maxKeep > 0 && count >= maxKeep) break;
+        // ֻ i ֮Ŀ i ֮ǰλȫ
+        uint64_t m = suppressMask(soa, i, w0 * 64, threshold) & ~((2ULL << (i & 63)) - 1);
+        removed[w0] |= m;
+        for (size_t w = w0 + 1; w < words; w++)
+            if (removed[w] != ~0ULL) removed[w] |= suppressMask(soa, i, w * 64, threshold);
+    }
+    return count;
+}
+
+class MaskNMS {
+public:
+    // maxKeep > 0 ʱ maxKeep ֹͣ
+    void run(const vector<Box>& boxes, float threshold, vector<Box>& out, int maxKeep = 0) {
+        int n = (int)boxes.size();
+        storage.resize(BoxSoA::floatsFor(n));
+        removed.resize(BoxSoA::paddedSize(n) / 64);
+        kept.resize(n);
+        soa.assign(boxes.data(), n, storage.data());
+        int count = maskSuppress(soa, threshold, removed.data(), kept.data(), maxKeep);
+        out.clear();
+        for (int k = 0; k < count; k++) out.push_back(boxes[kept[k]]);
+    }
+
+private:
+    BoxSoA soa;
+    vector<float> storage;
+    vector<uint64_t> removed;
+    vector<int> kept;
+};
+
+vector<Box> maskNMS(const vector<Box>& boxes, float threshold) {
+    MaskNMS engine;
+    vector<Box> result;
+    engine.run(boxes, threshold, result);
+    return result;
+}
+
+// ======================= ̳߳ =======================
+// פ̡߳run(n, f)  0..n-1 ִָ̬߳ f(tid, i)߳Ϊ 0 ̲߳룬ȫɺ󷵻ء
+// ָͨ + ָ· std::functionñڴ
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0) {
+        if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+        for (int t = 1; t < threads; t++) workers.push_back(thread(&ThreadPool::loop, this, t));
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lk(mtx);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& th : workers) th.join();
+    }
+
+    int size() const { return (int)workers.size() + 1; }
+
+    template <class F>
+    void run(int n, F& f) {
+        if (workers.empty() || n <= 1) {
+            for (int i = 0; i < n; i++) f(0, i);
+            return;
+        }
+        {
+            lock_guard<mutex> lk(mtx);
+            ctx = &f;
+            call = [](void* c, int tid, int i) { (*(F*)c)(tid, i); };
+            jobSize = n;
+            next = 0;
+            busy = (int)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        work(0, ctx, call, n);
+        unique_lock<mutex> lk(mtx);
+        done.wait(lk, [this] { return busy == 0; });
+    }
+
+private:
+    typedef void (*Call)(void*, int, int);
+    vector<thread> workers;
+    mutex mtx;
+    condition_variable wake, done;
+    void* ctx = nullptr;
+    Call call = nullptr;
+    int jobSize = 0;
+    atomic<int> next{ 0 };
+    int busy = 0;                 // δ걾Ĺ߳
+    long long generation = 0;     // ÿ·һһ߳̾ݴж
+    bool stopping = false;
+
+    void work(int tid, void* c, Call f, int n) {
+        for (int i; (i = next.fetch_add(1)) < n;) f(c, tid, i);
+    }
+
+    void loop(int tid) {
+        long long seen = 0;
+        for (;;) {
+            unique_lock<mutex> lk(mtx);
+            wake.wait(lk, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            void* c = ctx;
+            Call f = call;
+            int n = jobSize;
+            lk.unlock();
+            work(tid, c, f, n);
+            lk.lock();
+            if (--busy == 0) done.notify_one();
+        }
+    }
+};
+
+// =======================  NMS =======================
+struct Detection {
+    Box box;
+    int classId;
+};
+
+enum NMSMethod { NMS_HARD, NMS_SOFT_LINEAR, NMS_SOFT_GAUSSIAN };
+
+struct BatchNMSConfig {
+    NMSMethod method = NMS_HARD;
+    float iouThreshold = 0.5f;
+    float sigma = 0.5f;            // ˹ Soft-NMS ˥
+    float scoreThreshold = 0.001f; // ȰˣSoft-NMS ˥ĿҲ
+    int topK = 0;                  // ÿౣĿ0 ʾ
+};
+
+// Soft-NMSBodla ȣÿȡʣߵĿ IoU ˥ֱɾ
+// boxes ᱻԭź͸д
+void softNMS(vector<Box>& boxes, const BatchNMSConfig& cfg, vector<Box>& out) {
+    out.clear();
+    size_t n = boxes.size();
+    for (size_t i = 0; i < n; i++) {
+        size_t best = i;
+        for (size_t j = i + 1; j < n; j++)
+            if (boxes[j].score > boxes[best].score) best = j;
+        if (boxes[best].score < cfg.scoreThreshold) break;
+        swap(boxes[i], boxes[best]);
+        out.push_back(boxes[i]);
+        if (cfg.topK > 0 && (int)out.size() >= cfg.topK) break;
+
+        for (size_t j = i + 1; j < n; j++) {
+            float iou = IoU(boxes[i], boxes[j]);
+            if (cfg.method == NMS_SOFT_LINEAR) {
+                if (iou > cfg.iouThreshold) boxes[j].score *= 1 - iou;
+            }
+            else {
+                boxes[j].score *= exp(-iou * iou / cfg.sigma);
+            }
+        }
+    }
+}
+
+// һͼͼ NMSÿͼȰ (, ) źã (ͼ, ) ٽ̳߳زд
+// м仺ǳԱ֡ãȶÿ֡
+class BatchNMS {
+public:
+    BatchNMSConfig config;
+
+    explicit BatchNMS(int threads = 0) : pool(threads), workspaces(pool.size()) {}
+
+    int threads() const { return pool.size(); }
+
+    void run(const vector<vector<Detection>>& images, vector<vector<Detection>>& results) {
+        int m = (int)images.size();
+        if ((int)order.size() < m) { order.resize(m); imageParts.resize(m); }
+        results.resize(m);
+
+        // 1. ÿͼ˵ͷֿ򡢰 (, , ±) г
+        auto group = [&](int, int img) {
+            const vector<Detection>& dets = images[img];
+            vector<int>& ord = order[img];
+            ord.clear();
+            for (int i = 0; i < (int)dets.size(); i++)
+                if (dets[i].box.score >= config.scoreThreshold) ord.push_back(i);
+            sort(ord.begin(), ord.end(), [&](int a, int b) {
+                if (dets[a].classId != dets[b].classId) return dets[a].classId < dets[b].classId;
+                if (dets[a].box.score != dets[b].box.score) return dets[a].box.score > dets[b].box.score;
+                return a < b;
+            });
+            vector<Partition>& ps = imageParts[img];
+            ps.clear();
+            for (int b = 0; b < (int)ord.size();) {
+                int e = b;
+                while (e < (int)ord.size() && dets[ord[e]].classId == dets[ord[b]].classId) e++;
+                ps.push_back({ img, dets[ord[b]].classId, b, e });
+                b = e;
+            }
+        };
+        pool.run(m, group);
+
+        parts.clear();
+        for (int img = 0; img < m; img++) parts.insert(parts.end(), imageParts[img].begin(), imageParts[img].end());
+        if (partOut.size() < parts.size()) partOut.resize(parts.size());
+
+        // 2.  NMS
+        auto suppress = [&](int tid, int p) {
+            const Partition& part = parts[p];
+            const vector<Detection>& dets = images[part.image];
+            const vector<int>& ord = order[part.image];
+            Workspace& ws = workspaces[tid];
+            ws.boxes.clear();
+            for (int k = part.begin; k < part.end; k++) ws.boxes.push_back(dets[ord[k]].box);
+            if (config.method == NMS_HARD) ws.nms.run(ws.boxes, config.iouThreshold, ws.kept, config.topK);
+            else softNMS(ws.boxes, config, ws.kept);
+
+            vector<Detection>& out = partOut[p];
+            out.clear();
+            for (const Box& b : ws.kept) out.push_back({ b, part.classId });
+        };
+        pool.run((int)parts.size(), suppress);
+
+        // 3. ͼƴӽС
+        for (int img = 0; img < m; img++) results[img].clear();
+        for (size_t p = 0; p < parts.size(); p++) {
+            vector<Detection>& dst = results[parts[p].image];
+            dst.insert(dst.end(), partOut[p].begin(), partOut[p].end());
+        }
+    }
+
+private:
+    struct Partition {
+        int image, classId;
+        int begin, end;   // ڸͼ±е
+    };
+    struct Workspace {
+        MaskNMS nms;
+        vector<Box> boxes, kept;
+    };
+
+    ThreadPool pool;
+    vector<Workspace> workspaces;          // ÿ߳һ
+    vector<vector<int>> order;             // ÿͼļ±
+    vector<vector<Partition>> imageParts;  // ÿͼ
+    vector<Partition> parts;
+    vector<vector<Detection>> partOut;     // ÿĽ
+};
+
 // ======================= 㷨 =======================
 
 // 1. ð
@@ -121,6 +584,596 @@ void quickSort(vector<Box>& a, int l, int r) {
     }
 }
 
+// 5. 򣺰 IEEE 754 λģʽ LSD ÿ 8 λ 4 ˣȶʱ䣬зҲ˻
+// λģʽȡǸֻתλõ޷żȡΪ
+inline uint32_t scoreKey(float score) {
+    uint32_t u;
+    memcpy(&u, &score, sizeof u);
+    u = (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+    return ~u;
+}
+
+// ͳƵ shift λ 8 λķֲתɸͰʼλãȫͬһͰʱһ˿ false
+inline bool radixDigitOffsets(const uint32_t* ks, size_t n, int shift, size_t* offset) {
+    size_t count[256] = { 0 };
+    for (size_t i = 0; i < n; i++) count[(ks[i] >> shift) & 255]++;
+    if (count[(ks[0] >> shift) & 255] == n) return false;
+    size_t sum = 0;
+    for (int d = 0; d < 256; d++) { offset[d] = sum; sum += count[d]; }
+    return true;
+}
+
+//  keys ȶ atmp / keyTmp Ϊͬȵʱkeys ݻᱻ
+template <class T>
+void radixSortByKey(T* a, T* tmp, uint32_t* keys, uint32_t* keyTmp, size_t n) {
+    T* src = a;
+    T* dst = tmp;
+    uint32_t* ks = keys;
+    uint32_t* kd = keyTmp;
+    for (int shift = 0; shift < 32 && n > 1; shift += 8) {
+        size_t offset[256];
+        if (!radixDigitOffsets(ks, n, shift, offset)) continue;
+        for (size_t i = 0; i < n; i++) {
+            size_t pos = offset[(ks[i] >> shift) & 255]++;
+            dst[pos] = src[i];
+            kd[pos] = ks[i];
+        }
+        swap(src, dst);
+        swap(ks, kd);
+    }
+    if (src != a) copy(src, src + n, a);
+}
+
+// ʱΪԱθ
+class ScoreSorter {
+public:
+    // ȶ
+    void sort(vector<Box>& a) {
+        size_t n = a.size();
+        keys.resize(n); keyTmp.resize(n); boxTmp.resize(n);
+        for (size_t i = 0; i < n; i++) keys[i] = scoreKey(a[i].score);
+        radixSortByKey(a.data(), boxTmp.data(), keys.data(), keyTmp.data(), n);
+    }
+
+    // ȶ±idx Ϊе±꣬a ֻ 4 ֽڵ± Box
+    void sortIndices(const vector<Box>& a, vector<int>& idx) {
+        size_t n = a.size();
+        idx.resize(n);
+        keys.resize(n); keyTmp.resize(n); idxTmp.resize(n);
+        for (size_t i = 0; i < n; i++) { idx[i] = (int)i; keys[i] = scoreKey(a[i].score); }
+        radixSortByKey(idx.data(), idxTmp.data(), keys.data(), keyTmp.data(), n);
+    }
+
+    // a ֻ·ߵ k źãȶǰ k ͬ
+    // Ȱĸ 11 λͳֱͼҵ k ڵͰʱ綼 [0.5, 1)Ͱװ¼п
+    // Ͱڰ 11 λ 10 λٷֱ֣ͰĿ򲻳 kֻѸͰǰĿȥ
+    void topK(vector<Box>& a, size_t k) {
+        if (k >= a.size()) { sort(a); return; }
+        static const int SHIFT[3] = { 21, 10, 0 }, WIDTH[3] = { 11, 11, 10 };
+        uint32_t prefix = 0;   //  k ļѴλϵֵ
+        size_t need = k;       // Ҫ prefix Ͱȡĸ
+        int level = 0;
+        for (;; level++) {
+            int shift = SHIFT[level], high = shift + WIDTH[level];
+            uint32_t mask = (1u << WIDTH[level]) - 1;
+            bucketCount.assign((size_t)1 << WIDTH[level], 0);
+            for (const Box& b : a) {
+                uint32_t key = scoreKey(b.score);
+                if (level == 0 || (key >> high) == prefix) bucketCount[(key >> shift) & mask]++;
+            }
+            uint32_t cut = 0;
+            for (; bucketCount[cut] < need; cut++) need -= bucketCount[cut];
+            prefix = (prefix << WIDTH[level]) | cut;
+            if (level == 2 || bucketCount[cut] - need <= k) break;
+        }
+        candidates.clear();
+        for (const Box& b : a)
+            if ((scoreKey(b.score) >> SHIFT[level]) <= prefix) candidates.push_back(b);
+        sort(candidates);
+        a.assign(candidates.begin(), candidates.begin() + k);
+    }
+
+private:
+    vector<uint32_t> keys, keyTmp;
+    vector<Box> boxTmp, candidates;
+    vector<int> idxTmp;
+    vector<size_t> bucketCount;
+};
+
+void radixSort(vector<Box>& a) {
+    ScoreSorter sorter;
+    sorter.sort(a);
+}
+
+void radixSortIndices(const vector<Box>& a, vector<int>& idx) {
+    ScoreSorter sorter;
+    sorter.sortIndices(a, idx);
+}
+
+void radixTopK(vector<Box>& a, size_t k) {
+    ScoreSorter sorter;
+    sorter.topK(a, k);
+}
+
+// ======================= ʽ =======================
+// ڴϵ˳ÿ֡ rewind ͷг 64 ֽڶ飬ͷš
+// ֻ reserve ʱ루ϣ֡Сȶٷ
+class Arena {
+public:
+    template <class T>
+    static size_t footprint(size_t count) { return (count * sizeof(T) + 63) & ~(size_t)63; }
+
+    void reserve(size_t bytes) {
+        if (bytes <= capacity) return;
+        storage.reset(new unsigned char[bytes + 63]);
+        capacity = bytes;
+        growths++;
+        rewind();
+    }
+
+    void rewind() {
+        base = (unsigned char*)(((uintptr_t)storage.get() + 63) & ~(uintptr_t)63);
+        used = 0;
+    }
+
+    template <class T>
+    T* alloc(size_t count) {
+        T* p = (T*)(base + used);
+        used += footprint<T>(count);
+        return p;
+    }
+
+    int growthCount() const { return growths; }
+
+private:
+    unique_ptr<unsigned char[]> storage;
+    unsigned char* base = nullptr;
+    size_t capacity = 0, used = 0;
+    int growths = 0;
+};
+
+// ׶Σǵ÷ָ + 
+
+// ֵĿд outͬʱдظ
+size_t filterByScore(const Box* boxes, size_t n, float threshold, Box* out, uint32_t* keys) {
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++)
+        if (boxes[i].score >= threshold) {
+            out[m] = boxes[i];
+            keys[m++] = scoreKey(boxes[i].score);
+        }
+    return m;
+}
+
+// boxes ȶtmp / keyTmp Ϊʱ
+void sortByScore(Box* boxes, size_t n, uint32_t* keys, Box* tmp, uint32_t* keyTmp) {
+    radixSortByKey(boxes, tmp, keys, keyTmp, n);
+}
+
+//  boxes  NMSĿд out outCapacity soaMem / removed / kept Ϊʱ
+size_t suppressInto(const Box* boxes, size_t n, float threshold, Box* out, size_t outCapacity,
+    float* soaMem, uint64_t* removed, int* kept) {
+    if (outCapacity == 0) return 0;
+    BoxSoA soa;
+    soa.assign(boxes, (int)n, soaMem);
+    int count = maskSuppress(soa, threshold, removed, kept, (int)min(outCapacity, n));
+    for (int k = 0; k < count; k++) out[k] = boxes[kept[k]];
+    return count;
+}
+
+struct PostprocessConfig {
+    float scoreThreshold = 0.05f;
+    float iouThreshold = 0.5f;
+    size_t maxCandidates = 0;   // ֻѷߵô򽻸 NMS0 ʾ
+};
+
+// ֡õļ ->  -> λ NMSм鶼һ Arena г
+// ֡ȷҲԹʱԤڿ֮ÿ֡жѷ
+class DetectionPostprocessor {
+public:
+    PostprocessConfig config;
+
+    explicit DetectionPostprocessor(size_t expectedBoxes = 0) { reserve(expectedBoxes); }
+
+    void reserve(size_t n) {
+        if (n <= capacityBoxes) return;
+        arena.reserve(2 * Arena::footprint<Box>(n) + 2 * Arena::footprint<uint32_t>(n)
+            + Arena::footprint<float>(BoxSoA::floatsFor(n)) + Arena::footprint<uint64_t>(BoxSoA::paddedSize(n) / 64)
+            + Arena::footprint<int>(n));
+        capacityBoxes = n;
+    }
+
+    // һ֡Ŀд out outCapacity д
+    size_t process(const Box* boxes, size_t n, Box* out, size_t outCapacity) {
+        // ֡֡ 1.25 ֡Ķ
+        if (n > capacityBoxes) reserve(n + n / 4);
+        arena.rewind();
+        Box* cand = arena.alloc<Box>(n);
+        Box* boxTmp = arena.alloc<Box>(n);
+        uint32_t* keys = arena.alloc<uint32_t>(n);
+        uint32_t* keyTmp = arena.alloc<uint32_t>(n);
+
+        size_t m = filterByScore(boxes, n, config.scoreThreshold, cand, keys);
+        sortByScore(cand, m, keys, boxTmp, keyTmp);
+        if (config.maxCandidates > 0 && m > config.maxCandidates) m = config.maxCandidates;
+
+        float* soaMem = arena.alloc<float>(BoxSoA::floatsFor(m));
+        uint64_t* removed = arena.alloc<uint64_t>(BoxSoA::paddedSize(m) / 64);
+        int* kept = arena.alloc<int>(m);
+        return suppressInto(cand, m, config.iouThreshold, out, outCapacity, soaMem, removed, kept);
+    }
+
+    int arenaGrowths() const { return arena.growthCount(); }
+
+private:
+    Arena arena;
+    size_t capacityBoxes = 0;
+};
+
+// ======================= ֡ =======================
+enum AssignMethod { ASSIGN_GREEDY, ASSIGN_HUNGARIAN };
+
+// һѡ (, 켣) Լ IoU
+struct MatchCandidate {
+    float iou;
+    int det, track;
+};
+
+// ̰ƥĴ˳IoU 򣬲ʱ⡢켣±򣬱֤ȷ
+bool candidateBefore(const MatchCandidate& a, const MatchCandidate& b) {
+    if (a.iou != b.iou) return a.iou > b.iou;
+    return a.det != b.det ? a.det < b.det : a.track < b.track;
+}
+
+// Ѽ켣һһƥ䣬ֻ IoU > threshold ĶԲſϡ
+// ѡɾ켣ĵǼǣ GridNMS ͬ IoU  t Ĺ켣
+// ıڼ max(0, 0.5 - t) 켣ķΧڡõϡ IoU 
+// ̰ģIoU ӴСԣͨ㷨ƥԵ IoU ֮ͣ
+class BoxMatcher {
+public:
+    int hungarianLimit = 256;   // ͨʱ÷˻̰ģ O(k^3) ʧ
+
+    // matchOfDet[i] Ϊ i ϵĹ켣±꣬ûΪ -1
+    void match(const vector<Box>& tracks, const vector<Box>& dets, float threshold,
+        AssignMethod method, vector<int>& matchOfDet);
+
+    size_t candidateCount() const { return cands.size(); }
+
+private:
+    struct Entry {
+        float cx, cy;
+        int track;
+        int next;
+    };
+    float minX = 0, minY = 0, cell = 1;
+    int gx = 1, gy = 1;
+    vector<int> cellHead;
+    vector<Entry> entries;
+    vector<MatchCandidate> cands;
+    vector<int> matchOfTrack;
+    // ͨ㷨ʱĹ
+    vector<int> parent, compStart, local;
+    vector<MatchCandidate> grouped;
+    vector<double> cost, u, v, minv;
+    vector<char> allowed, used;
+    vector<int> p, way, rows, cols;
+
+    int cellOf(float val, float lo, int cnt) const {
+        float c = (val - lo) / cell;
+        if (!(c > 0)) return 0;
+        return c >= cnt - 1 ? cnt - 1 : (int)c;
+    }
+    int find(int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    }
+    void collectCandidates(const vector<Box>& tracks, const vector<Box>& dets, float threshold);
+    void greedy(const MatchCandidate* first, const MatchCandidate* last, vector<int>& matchOfDet);
+    void hungarian(vector<int>& matchOfDet);
+    void solveComponent(MatchCandidate* first, MatchCandidate* last, vector<int>& matchOfDet);
+};
+
+void BoxMatcher::collectCandidates(const vector<Box>& tracks, const vector<Box>& dets, float threshold) {
+    cands.clear();
+    int m = (int)tracks.size(), n = (int)dets.size();
+    if (m == 0 || n == 0) return;
+    if (threshold < 0) {
+        // ֵ < 0 ʱཻĿҲѡ֦ʧЧ
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < m; j++) {
+                float iou = IoU(tracks[j], dets[i]);
+                if (iou > threshold) cands.push_back({ iou, i, j });
+            }
+        return;
+    }
+
+    float maxX = tracks[0].x1, maxY = tracks[0].y1;
+    minX = maxX; minY = maxY;
+    float maxW = 0, maxH = 0;
+    double sizeSum = 0;
+    for (const Box& b : tracks) {
+        minX = min(minX, min(b.x1, b.x2)); maxX = max(maxX, max(b.x1, b.x2));
+        minY = min(minY, min(b.y1, b.y2)); maxY = max(maxY, max(b.y1, b.y2));
+        float bw = fabs(b.x2 - b.x1), bh = fabs(b.y2 - b.y1);
+        maxW = max(maxW, bw); maxH = max(maxH, bh);
+        sizeSum += max(bw, bh);
+    }
+    float slack = max(0.0f, 0.5f - threshold) + 0.001f;
+    float padX = slack * maxW, padY = slack * maxH;
+
+    // ӱ߳ȡƽ켣ߴһ룬 4m
+    double w = (double)maxX - minX, h = (double)maxY - minY;
+    double c = max(sizeSum / m / 2, sqrt(w * h / (4.0 * m)));
+    c = max(c, max(w, h) / 4096);
+    if (!(c > 0)) c = 1;
+    cell = (float)c;
+    gx = (int)(w / c) + 1;
+    gy = (int)(h / c) + 1;
+
+    cellHead.assign((size_t)gx * gy, -1);
+    entries.clear();
+    for (int j = 0; j < m; j++) {
+        const Box& b = tracks[j];
+        float cx = (b.x1 + b.x2) * 0.5f, cy = (b.y1 + b.y2) * 0.5f;
+        int& head = cellHead[(size_t)cellOf(cy, minY, gy) * gx + cellOf(cx, minX, gx)];
+        entries.push_back({ cx, cy, j, head });
+        head = (int)entries.size() - 1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const Box& b = dets[i];
+        float qx1 = min(b.x1, b.x2) - padX, qx2 = max(b.x1, b.x2) + padX;
+        float qy1 = min(b.y1, b.y2) - padY, qy2 = max(b.y1, b.y2) + padY;
+        if (qx2 < minX - padX || qy2 < minY - padY || qx1 > maxX + padX || qy1 > maxY + padY) continue;
+        int cx0 = cellOf(qx1, minX, gx), cx1 = cellOf(qx2, minX, gx);
+        int cy0 = cellOf(qy1, minY, gy), cy1 = cellOf(qy2, minY, gy);
+        for (int y = cy0; y <= cy1; y++)
+            for (int x = cx0; x <= cx1; x++)
+                for (int e = cellHead[(size_t)y * gx + x]; e >= 0; e = entries[e].next) {
+                    const Entry& en = entries[e];
+                    if (en.cx < qx1 || en.cx > qx2 || en.cy < qy1 || en.cy > qy2) continue;
+                    float iou = IoU(tracks[en.track], b);
+                    if (iou > threshold) cands.push_back({ iou, i, en.track });
+                }
+    }
+}
+
+void BoxMatcher::greedy(const MatchCandidate* first, const MatchCandidate* last, vector<int>& matchOfDet) {
+    for (const MatchCandidate* c = first; c != last; ++c)
+        if (matchOfDet[c->det] < 0 && matchOfTrack[c->track] < 0) {
+            matchOfDet[c->det] = c->track;
+            matchOfTrack[c->track] = c->det;
+        }
+}
+
+// ѡ԰ͼͨ飬֮以Ӱ죬
+void BoxMatcher::hungarian(vector<int>& matchOfDet) {
+    int n = (int)matchOfDet.size(), m = (int)matchOfTrack.size();
+    parent.resize(n + m);
+    for (int i = 0; i < n + m; i++) parent[i] = i;
+    for (const MatchCandidate& c : cands) {
+        int a = find(c.det), b = find(n + c.track);
+        if (a != b) parent[a] = b;
+    }
+
+    // ͬһĺѡ
+    compStart.assign(n + m + 1, 0);
+    for (const MatchCandidate& c : cands) compStart[find(c.det) + 1]++;
+    for (int i = 0; i < n + m; i++) compStart[i + 1] += compStart[i];
+    grouped.resize(cands.size());
+    local.assign(compStart.begin(), compStart.end() - 1);   // дλ
+    for (const MatchCandidate& c : cands) grouped[local[find(c.det)]++] = c;
+
+    local.assign(n + m, -1);
+    for (int r = 0; r < n + m; r++) {
+        int b = compStart[r], e = compStart[r + 1];
+        if (b == e) continue;
+        if (e - b == 1) {
+            matchOfDet[grouped[b].det] = grouped[b].track;
+            matchOfTrack[grouped[b].track] = grouped[b].det;
+            continue;
+        }
+        solveComponent(grouped.data() + b, grouped.data() + e, matchOfDet);
+    }
+}
+
+// һ㷨ƺ + ·O(k^3)ȡ 1 - IoU
+// Ǻѡ벹д۶ 1൱ڡ䡱ֻܺѡ
+void BoxMatcher::solveComponent(MatchCandidate* first, MatchCandidate* last, vector<int>& matchOfDet) {
+    int n = (int)matchOfDet.size();
+    rows.clear(); cols.clear();
+    for (const MatchCandidate* c = first; c != last; ++c) {
+        if (local[c->det] < 0) { local[c->det] = (int)rows.size(); rows.push_back(c->det); }
+        if (local[n + c->track] < 0) { local[n + c->track] = (int)cols.size(); cols.push_back(c->track); }
+    }
+    int k = (int)max(rows.size(), cols.size());
+    if (k > hungarianLimit) {
+        sort(first, last, candidateBefore);
+        greedy(first, last, matchOfDet);
+        return;
+    }
+
+    cost.assign((size_t)k * k, 1.0);
+    allowed.assign((size_t)k * k, 0);
+    for (const MatchCandidate* c = first; c != last; ++c) {
+        size_t at = (size_t)local[c->det] * k + local[n + c->track];
+        cost[at] = 1.0 - c->iou;
+        allowed[at] = 1;
+    }
+
+    // 1 ±꣺p[j] Ϊ j ϵУway ¼·
+    const double INF = 1e18;
+    u.assign(k + 1, 0); v.assign(k + 1, 0);
+    p.assign(k + 1, 0); way.assign(k + 1, 0);
+    for (int i = 1; i <= k; i++) {
+        p[0] = i;
+        int j0 = 0;
+        minv.assign(k + 1, INF);
+        used.assign(k + 1, 0);
+        do {
+            used[j0] = 1;
+            int i0 = p[j0], j1 = 0;
+            double delta = INF;
+            const double* row = &cost[(size_t)(i0 - 1) * k];
+            for (int j = 1; j <= k; j++) {
+                if (used[j]) continue;
+                double cur = row[j - 1] - u[i0] - v[j];
+                if (cur < minv[j]) { minv[j] = cur; way[j] = j0; }
+                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+            }
+            for (int j = 0; j <= k; j++) {
+                if (used[j]) { u[p[j]] += delta; v[j] -= delta; }
+                else minv[j] -= delta;
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0);
+    }
+
+    for (int j = 1; j <= k; j++) {
+        int r = p[j] - 1, c = j - 1;
+        if (r < (int)rows.size() && c < (int)cols.size() && allowed[(size_t)r * k + c]) {
+            matchOfDet[rows[r]] = cols[c];
+            matchOfTrack[cols[c]] = rows[r];
+        }
+    }
+    for (int d : rows) local[d] = -1;
+    for (int t : cols) local[n + t] = -1;
+}
+
+void BoxMatcher::match(const vector<Box>& tracks, const vector<Box>& dets, float threshold,
+    AssignMethod method, vector<int>& matchOfDet) {
+    matchOfDet.assign(dets.size(), -1);
+    matchOfTrack.assign(tracks.size(), -1);
+    collectCandidates(tracks, dets, threshold);
+    if (method == ASSIGN_GREEDY) {
+        sort(cands.begin(), cands.end(), candidateBefore);
+        greedy(cands.data(), cands.data() + cands.size(), matchOfDet);
+    } else {
+        hungarian(matchOfDet);
+    }
+}
+
+// οʵ֣n*m  IoU õȫѡԣٰͬ˳̰
+vector<int> bruteForceGreedyMatch(const vector<Box>& tracks, const vector<Box>& dets, float threshold) {
+    vector<MatchCandidate> cands;
+    for (int i = 0; i < (int)dets.size(); i++)
+        for (int j = 0; j < (int)tracks.size(); j++) {
+            float iou = IoU(tracks[j], dets[i]);
+            if (iou > threshold) cands.push_back({ iou, i, j });
+        }
+    sort(cands.begin(), cands.end(), candidateBefore);
+    vector<int> matchOfDet(dets.size(), -1), matchOfTrack(tracks.size(), -1);
+    for (const MatchCandidate& c : cands)
+        if (matchOfDet[c.det] < 0 && matchOfTrack[c.track] < 0) {
+            matchOfDet[c.det] = c.track;
+            matchOfTrack[c.track] = c.det;
+        }
+    return matchOfDet;
+}
+
+enum TrackState { TRACK_TENTATIVE, TRACK_CONFIRMED, TRACK_LOST };
+
+struct Track {
+    int id;
+    Box box;          // ǰλãʱȡ򣬶ʧʱٶ
+    float vx, vy;     // ÿ֡λƣָƽ
+    int hits;         // ۼϵ֡
+    int misses;       // ʧ֡
+    int age;          // ֡
+    TrackState state;
+};
+
+struct TrackerConfig {
+    float iouThreshold = 0.3f;       // Ԥ IoU Ĳƥ
+    int confirmHits = 3;             // ô֡̽תΪȷ
+    int maxMisses = 15;              // ȷϹĹ켣ʧô֡ɾ̽켣һ֡ɾ
+    float velocitySmoothing = 0.5f;  // ٶ = (1 - a) * ٶ + a * ֡λ
+    AssignMethod method = ASSIGN_GREEDY;
+};
+
+// ֡µĶĿ٣ģԤ켣뱾֡ IoU ƥ䣬
+// ϵĸλٶȣûϵļ½̽켣ûϵĹ켣붪ʧ״ֱ̬ɾ
+class Tracker {
+public:
+    TrackerConfig config;
+
+    // һ֡⣬ÿĹ켣 id½̽켣Ҳ㣩
+    const vector<int>& update(const vector<Box>& dets);
+
+    const vector<Track>& tracks() const { return active; }
+    size_t candidateCount() const { return matcher.candidateCount(); }
+    int confirmedCount() const {
+        int c = 0;
+        for (const Track& t : active) c += t.state == TRACK_CONFIRMED;
+        return c;
+    }
+
+private:
+    vector<Track> active;
+    vector<Box> predicted;
+    vector<int> matchOfDet, detTrackIds;
+    vector<char> matched;
+    BoxMatcher matcher;
+    int nextId = 0;
+};
+
+const vector<int>& Tracker::update(const vector<Box>& dets) {
+    predicted.resize(active.size());
+    for (size_t j = 0; j < active.size(); j++) {
+        Box b = active[j].box;
+        b.x1 += active[j].vx; b.x2 += active[j].vx;
+        b.y1 += active[j].vy; b.y2 += active[j].vy;
+        predicted[j] = b;
+    }
+    matcher.match(predicted, dets, config.iouThreshold, config.method, matchOfDet);
+
+    float a = config.velocitySmoothing;
+    matched.assign(active.size(), 0);
+    detTrackIds.assign(dets.size(), -1);
+    for (size_t i = 0; i < dets.size(); i++) {
+        int j = matchOfDet[i];
+        if (j < 0) continue;
+        Track& t = active[j];
+        float dx = (dets[i].x1 + dets[i].x2 - t.box.x1 - t.box.x2) * 0.5f;
+        float dy = (dets[i].y1 + dets[i].y2 - t.box.y1 - t.box.y2) * 0.5f;
+        t.vx = (1 - a) * t.vx + a * dx;
+        t.vy = (1 - a) * t.vy + a * dy;
+        t.box = dets[i];
+        t.hits++;
+        t.misses = 0;
+        if (t.state == TRACK_LOST || t.hits >= config.confirmHits) t.state = TRACK_CONFIRMED;
+        matched[j] = 1;
+        detTrackIds[i] = t.id;
+    }
+
+    // ûϵĹ켣һ֡̽켣붪ʧõĹ켣ԭѹ
+    size_t keep = 0;
+    for (size_t j = 0; j < active.size(); j++) {
+        Track& t = active[j];
+        t.age++;
+        if (!matched[j]) {
+            if (t.state == TRACK_TENTATIVE || ++t.misses > config.maxMisses) continue;
+            t.state = TRACK_LOST;
+            t.box = predicted[j];
+        }
+        active[keep++] = t;
+    }
+    active.resize(keep);
+
+    for (size_t i = 0; i < dets.size(); i++) {
+        if (matchOfDet[i] >= 0) continue;
+        Track t = { nextId++, dets[i], 0, 0, 1, 0, 1, config.confirmHits <= 1 ? TRACK_CONFIRMED : TRACK_TENTATIVE };
+        detTrackIds[i] = t.id;
+        active.push_back(t);
+    }
+    return detTrackIds;
+}
+
 // =======================  =======================
 
 // ֲ
@@ -161,6 +1214,16 @@ void testSort(const string& name, vector<Box> boxes, int type) {
     else if (type == 2) insertionSort(boxes);
     else if (type == 3) mergeSort(boxes, 0, boxes.size() - 1);
     else if (type == 4) quickSort(boxes, 0, boxes.size() - 1);
+    else if (type == 5) radixSort(boxes);
+    else if (type == 6) {
+        // ±±ȡ򽻸 NMSȡĿҲʱ
+        vector<int> idx;
+        radixSortIndices(boxes, idx);
+        vector<Box> ordered;
+        for (int i : idx) ordered.push_back(boxes[i]);
+        boxes.swap(ordered);
+    }
+    else if (type == 7) radixTopK(boxes, 1000);
 
     auto afterSort = chrono::high_resolution_clock::now();
     NMS(boxes, 0.5f);
@@ -174,9 +1237,345 @@ void testSort(const string& name, vector<Box> boxes, int type) {
         << " | ʱ(ms): " << totalTime << endl;
 }
 
+bool sameBoxes(const vector<Box>& a, const vector<Box>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].x1 != b[i].x1 || a[i].y1 != b[i].y1 || a[i].x2 != b[i].x2 || a[i].y2 != b[i].y2 || a[i].score != b[i].score)
+            return false;
+    return true;
+}
+
+// ͬһݰźֱ𽻸 NMSGridNMS  MaskNMSȽϺʱУһ
+void benchNMS(const string& name, vector<Box> boxes) {
+    quickSort(boxes, 0, (int)boxes.size() - 1);
+
+    auto t0 = chrono::high_resolution_clock::now();
+    vector<Box> ref = NMS(boxes, 0.5f);
+    auto t1 = chrono::high_resolution_clock::now();
+    GridNMS gridEngine;
+    vector<Box> grid;
+    gridEngine.run(boxes, 0.5f, grid);
+    auto t2 = chrono::high_resolution_clock::now();
+    MaskNMS maskEngine;
+    vector<Box> masked;
+    maskEngine.run(boxes, 0.5f, masked);
+    auto t3 = chrono::high_resolution_clock::now();
+
+    double naive = chrono::duration<double, milli>(t1 - t0).count();
+    double gridTime = chrono::duration<double, milli>(t2 - t1).count();
+    double maskTime = chrono::duration<double, milli>(t3 - t2).count();
+    cout << name << " n=" << boxes.size()
+        << " | NMS(ms): " << naive
+        << " | NMS(ms): " << gridTime
+        << " | NMS(ms): " << maskTime
+        << " | : " << ref.size()
+        << " | У: " << (sameBoxes(ref, grid) && sameBoxes(ref, masked) ? "һ" : "һ") << endl;
+}
+
+// ԣзʱ Lomuto ֵ quickSort ˻Ӱ졣
+//  stable_sort ĽΪ׼Уֻ
+void benchScoreSort(const string& name, const vector<Box>& boxes) {
+    auto timeIt = [](vector<Box> a, int type) {
+        auto t0 = chrono::high_resolution_clock::now();
+        if (type == 3) mergeSort(a, 0, (int)a.size() - 1);
+        else if (type == 4) quickSort(a, 0, (int)a.size() - 1);
+        else radixSort(a);
+        return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t0).count();
+    };
+
+    vector<Box> ref = boxes;
+    stable_sort(ref.begin(), ref.end(), [](const Box& a, const Box& b) { return a.score > b.score; });
+
+    ScoreSorter sorter;
+    vector<Box> radix = boxes, top = boxes;
+    vector<int> idx;
+    sorter.sort(radix);
+    auto t0 = chrono::high_resolution_clock::now();
+    sorter.sortIndices(boxes, idx);
+    auto t1 = chrono::high_resolution_clock::now();
+    sorter.topK(top, 2000);
+    auto t2 = chrono::high_resolution_clock::now();
+
+    bool ok = sameBoxes(ref, radix) && idx.size() == boxes.size();
+    for (size_t i = 0; i < idx.size() && ok; i++) ok = sameBoxes({ boxes[idx[i]] }, { ref[i] });
+    ok = ok && sameBoxes(vector<Box>(ref.begin(), ref.begin() + min<size_t>(2000, ref.size())), top);
+
+    cout << name << " n=" << boxes.size()
+        << " | Merge(ms): " << timeIt(boxes, 3)
+        << " | Quick(ms): " << timeIt(boxes, 4)
+        << " | Radix(ms): " << timeIt(boxes, 5)
+        << " | RadixIndex(ms): " << chrono::duration<double, milli>(t1 - t0).count()
+        << " | RadixTop2000(ms): " << chrono::duration<double, milli>(t2 - t1).count()
+        << " | У: " << (ok ? "һ" : "һ") << endl;
+}
+
+// ȡĵ p λ0..1
+double percentile(vector<double> v, double p) {
+    if (v.empty()) return 0;
+    size_t k = min(v.size() - 1, (size_t)(p * (v.size() - 1) + 0.5));
+    nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+vector<Detection> randomDetections(int n, int classes) {
+    vector<Detection> dets;
+    for (const Box& b : randomBoxes(n)) dets.push_back({ b, rand() % classes });
+    return dets;
+}
+
+// ̲߳οʵ֣ˡ NMS ضϵ topK
+vector<Detection> referenceBatchNMS(const vector<Detection>& dets, const BatchNMSConfig& cfg) {
+    int maxClass = 0;
+    for (const Detection& d : dets) maxClass = max(maxClass, d.classId);
+    vector<Detection> result;
+    for (int c = 0; c <= maxClass; c++) {
+        vector<pair<int, Box>> cls;
+        for (int i = 0; i < (int)dets.size(); i++)
+            if (dets[i].classId == c && dets[i].box.score >= cfg.scoreThreshold) cls.push_back({ i, dets[i].box });
+        sort(cls.begin(), cls.end(), [](const pair<int, Box>& a, const pair<int, Box>& b) {
+            return a.second.score != b.second.score ? a.second.score > b.second.score : a.first < b.first;
+        });
+        vector<Box> boxes;
+        for (auto& pr : cls) boxes.push_back(pr.second);
+        vector<Box> kept = NMS(boxes, cfg.iouThreshold);
+        if (cfg.topK > 0 && (int)kept.size() > cfg.topK) kept.resize(cfg.topK);
+        for (const Box& b : kept) result.push_back({ b, c });
+    }
+    return result;
+}
+
+// ģƵÿ֡ batch ͼÿͼ n ⡢classes ֡ʱӳٷλ
+void benchBatchNMS(const string& name, BatchNMS& engine, int frames, int batch, int n, int classes) {
+    vector<vector<vector<Detection>>> clips(4);
+    for (auto& clip : clips)
+        for (int i = 0; i < batch; i++) clip.push_back(randomDetections(n, classes));
+
+    vector<vector<Detection>> results;
+    vector<double> latency;
+    long long kept = 0;
+    for (int f = 0; f < frames; f++) {
+        const auto& frame = clips[f % clips.size()];
+        auto t0 = chrono::high_resolution_clock::now();
+        engine.run(frame, results);
+        auto t1 = chrono::high_resolution_clock::now();
+        latency.push_back(chrono::duration<double, milli>(t1 - t0).count());
+        for (auto& r : results) kept += r.size();
+    }
+
+    cout << name << " | ߳: " << engine.threads()
+        << " | ÿ֡ " << batch << " ͼ x " << n << "  x " << classes << " "
+        << " | ӳ(ms) p50: " << percentile(latency, 0.5)
+        << " p90: " << percentile(latency, 0.9)
+        << " p99: " << percentile(latency, 0.99)
+        << " max: " << percentile(latency, 1.0)
+        << " | ƽ: " << kept / frames;
+
+    if (engine.config.method == NMS_HARD) {
+        bool ok = true;
+        engine.run(clips[0], results);
+        for (int i = 0; i < batch && ok; i++) {
+            vector<Detection> ref = referenceBatchNMS(clips[0][i], engine.config);
+            ok = ref.size() == results[i].size();
+            for (size_t k = 0; k < ref.size() && ok; k++)
+                ok = ref[k].classId == results[i][k].classId && sameBoxes({ ref[k].box }, { results[i][k].box });
+        }
+        cout << " | У: " << (ok ? "һ" : "һ");
+    }
+    cout << endl;
+}
+
+// ģ 240 fps Ƶһ֮֡ͳƶѷ֡  + stable_sort + NMS Ĳοȶ
+void benchPostprocessor(int frames, int n) {
+    const size_t maxDetections = 300;
+    vector<vector<Box>> clips;
+    for (int i = 0; i < 8; i++) {
+        vector<Box> boxes = i % 2 ? clusteredBoxes(n - rand() % 5000) : randomBoxes(n - rand() % 5000);
+        clips.push_back(boxes);
+    }
+
+    DetectionPostprocessor post;
+    post.config.maxCandidates = 5000;
+    vector<Box> out(maxDetections);
+    vector<size_t> kept(frames);
+    vector<double> latency(frames);
+
+    long long warmupAllocations = 0, steadyAllocations = 0;
+    for (int f = 0; f < frames; f++) {
+        const vector<Box>& frame = clips[f % clips.size()];
+        long long before = heapAllocations.load();
+        auto t0 = chrono::high_resolution_clock::now();
+        kept[f] = post.process(frame.data(), frame.size(), out.data(), out.size());
+        auto t1 = chrono::high_resolution_clock::now();
+        long long allocs = heapAllocations.load() - before;
+        (f == 0 ? warmupAllocations : steadyAllocations) += allocs;
+        latency[f] = chrono::duration<double, milli>(t1 - t0).count();
+    }
+
+    bool ok = true;
+    for (size_t c = 0; c < clips.size() && ok; c++) {
+        vector<Box> ref;
+        for (const Box& b : clips[c]) if (b.score >= post.config.scoreThreshold) ref.push_back(b);
+        stable_sort(ref.begin(), ref.end(), [](const Box& a, const Box& b) { return a.score > b.score; });
+        if (ref.size() > post.config.maxCandidates) ref.resize(post.config.maxCandidates);
+        ref = NMS(ref, post.config.iouThreshold);
+        if (ref.size() > maxDetections) ref.resize(maxDetections);
+        size_t count = post.process(clips[c].data(), clips[c].size(), out.data(), out.size());
+        ok = sameBoxes(ref, vector<Box>(out.begin(), out.begin() + count));
+    }
+
+    cout << "ÿ֡Լ " << n << " " << frames << " ֡"
+        << " | ӳ(ms) p50: " << percentile(latency, 0.5)
+        << " p99: " << percentile(latency, 0.99)
+        << " max: " << percentile(latency, 1.0)
+        << " | ֡ѷ: " << warmupAllocations
+        << " | ֮ÿ֡ѷ: " << (double)steadyAllocations / max(1, frames - 1)
+        << " | Arena ݴ: " << post.arenaGrowths()
+        << " | У: " << (ok ? "һ" : "һ") << endl;
+}
+
+// ģƵobjects Ŀ 4000x4000 Ļ˶߷ 1 ض
+// ÿ֡© 2% 1% 죬˳ҡtruth ¼ÿӦĿ꣨Ϊ -1
+void trackingScene(int objects, int frames, vector<vector<Box>>& dets, vector<vector<int>>& truth) {
+    const float side = 4000;
+    struct Object { float x, y, w, h, vx, vy; };
+    vector<Object> objs(objects);
+    for (Object& o : objs) {
+        o.w = 20 + rand() % 40; o.h = 20 + rand() % 40;
+        o.x = rand() % (int)(side - o.w); o.y = rand() % (int)(side - o.h);
+        o.vx = (rand() % 601 - 300) / 100.0f; o.vy = (rand() % 601 - 300) / 100.0f;
+    }
+    auto jitter = []() { return (rand() % 201 - 100) / 100.0f; };
+    dets.assign(frames, {});
+    truth.assign(frames, {});
+    vector<int> perm;
+    for (int f = 0; f < frames; f++) {
+        vector<pair<Box, int>> frame;
+        for (int i = 0; i < objects; i++) {
+            Object& o = objs[i];
+            o.x += o.vx; o.y += o.vy;
+            if (o.x < 0 || o.x + o.w > side) { o.vx = -o.vx; o.x += 2 * o.vx; }
+            if (o.y < 0 || o.y + o.h > side) { o.vy = -o.vy; o.y += 2 * o.vy; }
+            if (rand() % 100 < 2) continue;
+            float x = o.x + jitter(), y = o.y + jitter();
+            frame.push_back({ { x, y, x + o.w + jitter(), y + o.h + jitter(), 0.5f + rand() % 50 / 100.0f }, i });
+        }
+        for (int k = 0; k < objects / 100; k++) {
+            float x = rand() % (int)side, y = rand() % (int)side;
+            frame.push_back({ { x, y, x + 20 + rand() % 40, y + 20 + rand() % 40, 0.3f }, -1 });
+        }
+        for (size_t k = frame.size(); k > 1; k--) swap(frame[k - 1], frame[rand() % k]);
+        for (auto& pr : frame) {
+            dets[f].push_back(pr.first);
+            truth[f].push_back(pr.second);
+        }
+    }
+}
+
+// ֡ٲʱ֡ļƥ䣬У̰ n*m ο̰Ľͬ
+//  IoU ܺͲ̰ġID лͬһĿα쵽ʱ켣 id ͬĴ
+void benchTracker(const string& name, AssignMethod method, int objects, int frames) {
+    vector<vector<Box>> dets;
+    vector<vector<int>> truth;
+    trackingScene(objects, frames, dets, truth);
+
+    Tracker tracker;
+    tracker.config.method = method;
+    vector<double> latency(frames);
+    vector<int> lastTrack(objects, -1);
+    long long switches = 0, candidates = 0, confirmed = 0;
+    for (int f = 0; f < frames; f++) {
+        auto t0 = chrono::high_resolution_clock::now();
+        const vector<int>& ids = tracker.update(dets[f]);
+        auto t1 = chrono::high_resolution_clock::now();
+        latency[f] = chrono::duration<double, milli>(t1 - t0).count();
+        candidates += tracker.candidateCount();
+        confirmed += tracker.confirmedCount();
+        for (size_t i = 0; i < ids.size(); i++) {
+            int g = truth[f][i];
+            if (g < 0) continue;
+            if (lastTrack[g] >= 0 && lastTrack[g] != ids[i]) switches++;
+            lastTrack[g] = ids[i];
+        }
+    }
+
+    bool ok = true;
+    double bruteMs = 0;
+    int checks = min(frames - 1, 10);
+    BoxMatcher matcher;
+    vector<int> greedyMatch, hungarianMatch;
+    float threshold = tracker.config.iouThreshold;
+    for (int f = 1; f <= checks && ok; f++) {
+        const vector<Box>& prev = dets[f - 1];
+        const vector<Box>& cur = dets[f];
+        auto t0 = chrono::high_resolution_clock::now();
+        vector<int> ref = bruteForceGreedyMatch(prev, cur, threshold);
+        auto t1 = chrono::high_resolution_clock::now();
+        bruteMs += chrono::duration<double, milli>(t1 - t0).count();
+        matcher.match(prev, cur, threshold, ASSIGN_GREEDY, greedyMatch);
+        matcher.match(prev, cur, threshold, ASSIGN_HUNGARIAN, hungarianMatch);
+        ok = greedyMatch == ref;
+
+        double greedySum = 0, hungarianSum = 0;
+        vector<char> taken(prev.size(), 0);
+        for (size_t i = 0; i < cur.size() && ok; i++) {
+            if (ref[i] >= 0) greedySum += IoU(prev[ref[i]], cur[i]);
+            int j = hungarianMatch[i];
+            if (j < 0) continue;
+            float iou = IoU(prev[j], cur[i]);
+            ok = !taken[j] && iou > threshold;
+            taken[j] = 1;
+            hungarianSum += iou;
+        }
+        ok = ok && hungarianSum >= greedySum - 1e-3;
+    }
+
+    cout << name << " | " << objects << " Ŀ x " << frames << " ֡"
+        << " | ӳ(ms) p50: " << percentile(latency, 0.5)
+        << " p99: " << percentile(latency, 0.99)
+        << " max: " << percentile(latency, 1.0)
+        << " | n*m οƥ(ms): " << bruteMs / max(1, checks)
+        << " | ƽѡ: " << candidates / frames
+        << " | ƽȷϹ켣: " << confirmed / frames
+        << " | ID л: " << switches
+        << " | У: " << (ok ? "һ" : "һ") << endl;
+}
+
 // =======================  =======================
-int main() {
+int main(int argc, char* argv[]) {
     srand((unsigned int)time(nullptr));
+
+    /* ܲģʽmain bench */
+    if (argc > 1 && string(argv[1]) == "bench") {
+        cout << "\nNMS ԣں: " << suppressKernelName() << "" << endl;
+        int nmsSizes[] = { 10000, 50000, 100000 };
+        for (int n : nmsSizes) benchNMS("ֲ", randomBoxes(n));
+        for (int n : nmsSizes) benchNMS("ۼֲ", clusteredBoxes(n));
+
+        cout << "\n" << endl;
+        benchScoreSort("ֲ", randomBoxes(1000000));
+        vector<Box> tied = randomBoxes(100000);
+        for (Box& b : tied) b.score = (rand() % 100) / 100.0f;
+        benchScoreSort("ٵз", tied);
+
+        cout << "\nʽ" << endl;
+        benchPostprocessor(240, 50000);
+
+        cout << "\n֡ٲ" << endl;
+        benchTracker("̰ƥ", ASSIGN_GREEDY, 5000, 300);
+        benchTracker("ƥ", ASSIGN_HUNGARIAN, 5000, 300);
+
+        cout << "\n NMS " << endl;
+        BatchNMS batch;
+        benchBatchNMS("Ӳ NMS", batch, 100, 8, 20000, 20);
+        batch.config.topK = 100;
+        benchBatchNMS("Ӳ NMS top-100", batch, 100, 8, 20000, 20);
+        batch.config.method = NMS_SOFT_GAUSSIAN;
+        benchBatchNMS("˹ Soft-NMS top-100", batch, 20, 8, 20000, 20);
+        batch.config.method = NMS_SOFT_LINEAR;
+        benchBatchNMS(" Soft-NMS top-100", batch, 20, 8, 20000, 20);
+        return 0;
+    }
+
     int sizes[] = { 100, 500, 1000, 5000, 10000 };
 
     for (int n : sizes) {
@@ -189,6 +1588,9 @@ int main() {
         testSort("Insertion", randomData, 2);
         testSort("Merge", randomData, 3);
         testSort("Quick", randomData, 4);
+        testSort("Radix", randomData, 5);
+        testSort("RadixIndex", randomData, 6);
+        testSort("RadixTop1000", randomData, 7);
 
         cout << "\n--- ۼֲ ---" << endl;
         auto clusterData = clusteredBoxes(n);
@@ -196,6 +1598,9 @@ int main() {
         testSort("Insertion", clusterData, 2);
         testSort("Merge", clusterData, 3);
         testSort("Quick", clusterData, 4);
+        testSort("Radix", clusterData, 5);
+        testSort("RadixIndex", clusterData, 6);
+        testSort("RadixTop1000", clusterData, 7);
     }
 
     return 0;